@@ -1,23 +1,44 @@
 ﻿#include <iostream>
 #include <cstdlib>
-#include <ctime>
 #include <chrono>
 #include <iomanip>
 #include <fstream>
 #include <vector>
 #include <string>
+#include <algorithm>
+#include <optional>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
 #include "open_addressing.hpp"
 #include "chaining.hpp"
 #include "avl.hpp"
+#include "hybrid.hpp"
+#include "concurrent_chaining.hpp"
+#include "lock_free_open_addressing.hpp"
+#include "concurrent_avl.hpp"
+#include "swiss_table.hpp"
+#include "robin_hood.hpp"
+#include "open_addressing_soa.hpp"
+#include "cuckoo_table.hpp"
+#include "workload.hpp"
 
 // Lancuchuowanie usuwanie 
 // napisać we wnioskach co nie wyszlo, dlaczego nie etc
 
 using namespace std;
 
+// Ziarno pierwszego zestawu danych - zestaw d uzywa ziarna DATA_SEED + d,
+// wiec wyniki mozna odtworzyc
+const unsigned long long DATA_SEED = 12345;
+
+// Generator danych testow (workload.hpp), szybszy i z wiekszym zakresem niz rand()
+FastRandom generator(DATA_SEED);
+
 // Generowanie losowej liczby 
 int randomInt(int min, int max) {
-    return min + rand() % (max - min + 1);
+    return generator.nextInt(min, max);
 }
 
 // Testowanie wydajnosci operacji 
@@ -37,8 +58,10 @@ void testPerformance() {
 
     // Utworzenie pliku wyjsciowego
     ofstream outFile("wyniki_final2.xlsx");
-    outFile << "Rozmiar\tAdresowanie otwarte Wstawianie (ns)\tLancuchowanie Wstawianie (ns)\tAVL Wstawianie (ns)\t"
-        << "Adresowanie otwarte Usuwanie (ns)\tLancuchowanie Usuwanie (ns)\tAVL Usuwanie (ns)\n";
+    outFile << "Rozmiar\tAdresowanie otwarte Wstawianie (ns)\tLancuchowanie Wstawianie (ns)\tAVL Wstawianie (ns)\tSwiss Wstawianie (ns)\tRobin Hood Wstawianie (ns)\tAdresowanie otwarte SoA Wstawianie (ns)\tKukulcze Wstawianie (ns)\t"
+        << "Adresowanie otwarte Usuwanie (ns)\tLancuchowanie Usuwanie (ns)\tAVL Usuwanie (ns)\tSwiss Usuwanie (ns)\tRobin Hood Usuwanie (ns)\tAdresowanie otwarte SoA Usuwanie (ns)\tKukulcze Usuwanie (ns)\t"
+        << "Adresowanie otwarte Pamiec (B)\tAdresowanie otwarte SoA Pamiec (B)\tKukulcze Pamiec (B)\t"
+        << "Lancuchowanie Pula (B)\tLancuchowanie Pula (bloki)\tAVL Pula (B)\tAVL Pula (bloki)\n";
 
     // Dla kazdego rozmiaru
     for (int s = 0; s < numSizes; s++) {
@@ -49,21 +72,41 @@ void testPerformance() {
         double avgOpenAddressingInsert = 0;
         double avgChainingInsert = 0;
         double avgAVLInsert = 0;
+        double avgSwissInsert = 0;
+        double avgRobinHoodInsert = 0;
+        double avgSoAInsert = 0;
+        double avgCuckooInsert = 0;
         double avgOpenAddressingRemove = 0;
         double avgChainingRemove = 0;
         double avgAVLRemove = 0;
+        double avgSwissRemove = 0;
+        double avgRobinHoodRemove = 0;
+        double avgSoARemove = 0;
+        double avgCuckooRemove = 0;
+        double avgOpenAddressingMemory = 0;
+        double avgSoAMemory = 0;
+        double avgCuckooMemory = 0;
+        double avgChainingPoolBytes = 0;
+        double avgChainingPoolSlabs = 0;
+        double avgAVLPoolBytes = 0;
+        double avgAVLPoolSlabs = 0;
 
         // Dla kazdego zestawu danych
         for (int dataSet = 0; dataSet < n; dataSet++) {
             cout << "  Zestaw danych " << dataSet + 1 << " z " << n << endl;
 
             // Inicjalizacja generatora losowego z roznym ziarnem dla kazdego zestawu danych
-            srand(time(nullptr) + dataSet);
+            generator.setSeed(DATA_SEED + dataSet);
 
             // Stworzenie oryginalnych tablic o rozmiarze 'size'
-            HashTableOpenAddressing originalOpenAddressing;
-            HashTableChaining originalChaining;
-            HashTableAVL originalAVL;
+            // (trzy podstawowe tablice sa budowane naraz, bez kolejnych zmian rozmiaru)
+            HashTableOpenAddressing<> originalOpenAddressing;
+            HashTableChaining<> originalChaining;
+            HashTableAVL<> originalAVL;
+            HashTableSwiss originalSwiss;
+            HashTableRobinHood originalRobinHood;
+            HashTableOpenAddressingSoA originalSoA;
+            HashTableCuckoo originalCuckoo;
 
             // Wypełnienie oryginalnych tablic
             vector<int> originalKeys(size);
@@ -73,11 +116,29 @@ void testPerformance() {
                 originalKeys[i] = randomInt(1, size * 10);
                 originalValues[i] = randomInt(1, 1000);
 
-                originalOpenAddressing.insert(originalKeys[i], originalValues[i]);
-                originalChaining.insert(originalKeys[i], originalValues[i]);
-                originalAVL.insert(originalKeys[i], originalValues[i]);
+                originalSwiss.insert(originalKeys[i], originalValues[i]);
+                originalRobinHood.insert(originalKeys[i], originalValues[i]);
+                originalSoA.insert(originalKeys[i], originalValues[i]);
+                originalCuckoo.insert(originalKeys[i], originalValues[i]);
             }
 
+            originalOpenAddressing.build(originalKeys.data(), originalValues.data(), size);
+            originalChaining.build(originalKeys.data(), originalValues.data(), size);
+            originalAVL.build(originalKeys.data(), originalValues.data(), size);
+
+            // Zuzycie pamieci przez tablice z adresowaniem otwartym
+            avgOpenAddressingMemory += originalOpenAddressing.getMemoryUsage();
+            avgSoAMemory += originalSoA.getMemoryUsage();
+            avgCuckooMemory += originalCuckoo.getMemoryUsage();
+
+            // Statystyki pul wezlow
+            PoolStats chainingPool = originalChaining.getPoolStats();
+            PoolStats avlPool = originalAVL.getPoolStats();
+            avgChainingPoolBytes += chainingPool.bytes;
+            avgChainingPoolSlabs += chainingPool.slabs;
+            avgAVLPoolBytes += avlPool.bytes;
+            avgAVLPoolSlabs += avlPool.slabs;
+
             // Testowanie operacji wstawiania
             for (int r = 0; r < rep; r++) {
                 // Przygotowanie nowych kluczy do wstawienia
@@ -85,7 +146,7 @@ void testPerformance() {
                 int newValue = randomInt(1, 1000);
 
                 // Test wstawiania dla adresowania otwartego
-                HashTableOpenAddressing testOpenAddressing = originalOpenAddressing;
+                HashTableOpenAddressing<> testOpenAddressing = originalOpenAddressing;
                 auto start = chrono::high_resolution_clock::now();
                 testOpenAddressing.insert(newKey, newValue);
                 auto end = chrono::high_resolution_clock::now();
@@ -93,7 +154,7 @@ void testPerformance() {
                 avgOpenAddressingInsert += duration;
 
                 // Test wstawiania dla lancuchowania
-                HashTableChaining testChaining = originalChaining;
+                HashTableChaining<> testChaining = originalChaining;
                 start = chrono::high_resolution_clock::now();
                 testChaining.insert(newKey, newValue);
                 end = chrono::high_resolution_clock::now();
@@ -101,12 +162,44 @@ void testPerformance() {
                 avgChainingInsert += duration;
 
                 // Test wstawiania dla AVL
-                HashTableAVL testAVL = originalAVL;
+                HashTableAVL<> testAVL = originalAVL;
                 start = chrono::high_resolution_clock::now();
                 testAVL.insert(newKey, newValue);
                 end = chrono::high_resolution_clock::now();
                 duration = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
                 avgAVLInsert += duration;
+
+                // Test wstawiania dla tablicy Swiss
+                HashTableSwiss testSwiss = originalSwiss;
+                start = chrono::high_resolution_clock::now();
+                testSwiss.insert(newKey, newValue);
+                end = chrono::high_resolution_clock::now();
+                duration = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+                avgSwissInsert += duration;
+
+                // Test wstawiania dla Robin Hood
+                HashTableRobinHood testRobinHood = originalRobinHood;
+                start = chrono::high_resolution_clock::now();
+                testRobinHood.insert(newKey, newValue);
+                end = chrono::high_resolution_clock::now();
+                duration = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+                avgRobinHoodInsert += duration;
+
+                // Test wstawiania dla adresowania otwartego SoA
+                HashTableOpenAddressingSoA testSoA = originalSoA;
+                start = chrono::high_resolution_clock::now();
+                testSoA.insert(newKey, newValue);
+                end = chrono::high_resolution_clock::now();
+                duration = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+                avgSoAInsert += duration;
+
+                // Test wstawiania dla tablicy kukulczej
+                HashTableCuckoo testCuckoo = originalCuckoo;
+                start = chrono::high_resolution_clock::now();
+                testCuckoo.insert(newKey, newValue);
+                end = chrono::high_resolution_clock::now();
+                duration = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+                avgCuckooInsert += duration;
             }
 
             // Testowanie operacji usuwania
@@ -114,7 +207,7 @@ void testPerformance() {
                 int keyToRemove = originalKeys[randomInt(0, size - 1)];
 
                 // Test usuwania dla adresowania otwartego
-                HashTableOpenAddressing testOpenAddressing = originalOpenAddressing;
+                HashTableOpenAddressing<> testOpenAddressing = originalOpenAddressing;
                 auto start = chrono::high_resolution_clock::now();
                 testOpenAddressing.remove(keyToRemove);
                 auto end = chrono::high_resolution_clock::now();
@@ -122,7 +215,7 @@ void testPerformance() {
                 avgOpenAddressingRemove += duration;
 
                 // Test usuwania dla lancuchowania
-                HashTableChaining testChaining = originalChaining;
+                HashTableChaining<> testChaining = originalChaining;
                 start = chrono::high_resolution_clock::now();
                 testChaining.remove(keyToRemove);
                 end = chrono::high_resolution_clock::now();
@@ -130,12 +223,44 @@ void testPerformance() {
                 avgChainingRemove += duration;
 
                 // Test usuwania dla AVL
-                HashTableAVL testAVL = originalAVL;
+                HashTableAVL<> testAVL = originalAVL;
                 start = chrono::high_resolution_clock::now();
                 testAVL.remove(keyToRemove);
                 end = chrono::high_resolution_clock::now();
                 duration = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
                 avgAVLRemove += duration;
+
+                // Test usuwania dla tablicy Swiss
+                HashTableSwiss testSwiss = originalSwiss;
+                start = chrono::high_resolution_clock::now();
+                testSwiss.remove(keyToRemove);
+                end = chrono::high_resolution_clock::now();
+                duration = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+                avgSwissRemove += duration;
+
+                // Test usuwania dla Robin Hood
+                HashTableRobinHood testRobinHood = originalRobinHood;
+                start = chrono::high_resolution_clock::now();
+                testRobinHood.remove(keyToRemove);
+                end = chrono::high_resolution_clock::now();
+                duration = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+                avgRobinHoodRemove += duration;
+
+                // Test usuwania dla adresowania otwartego SoA
+                HashTableOpenAddressingSoA testSoA = originalSoA;
+                start = chrono::high_resolution_clock::now();
+                testSoA.remove(keyToRemove);
+                end = chrono::high_resolution_clock::now();
+                duration = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+                avgSoARemove += duration;
+
+                // Test usuwania dla tablicy kukulczej
+                HashTableCuckoo testCuckoo = originalCuckoo;
+                start = chrono::high_resolution_clock::now();
+                testCuckoo.remove(keyToRemove);
+                end = chrono::high_resolution_clock::now();
+                duration = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+                avgCuckooRemove += duration;
             }
         }
 
@@ -143,27 +268,70 @@ void testPerformance() {
         avgOpenAddressingInsert /= (n * rep);
         avgChainingInsert /= (n * rep);
         avgAVLInsert /= (n * rep);
+        avgSwissInsert /= (n * rep);
+        avgRobinHoodInsert /= (n * rep);
+        avgSoAInsert /= (n * rep);
+        avgCuckooInsert /= (n * rep);
         avgOpenAddressingRemove /= (n * rep);
         avgChainingRemove /= (n * rep);
         avgAVLRemove /= (n * rep);
+        avgSwissRemove /= (n * rep);
+        avgRobinHoodRemove /= (n * rep);
+        avgSoARemove /= (n * rep);
+        avgCuckooRemove /= (n * rep);
+        avgOpenAddressingMemory /= n;
+        avgSoAMemory /= n;
+        avgCuckooMemory /= n;
+        avgChainingPoolBytes /= n;
+        avgChainingPoolSlabs /= n;
+        avgAVLPoolBytes /= n;
+        avgAVLPoolSlabs /= n;
 
         // Zapisywanie wynikow do pliku
         outFile << size << "\t"
             << avgOpenAddressingInsert << "\t"
             << avgChainingInsert << "\t"
             << avgAVLInsert << "\t"
+            << avgSwissInsert << "\t"
+            << avgRobinHoodInsert << "\t"
+            << avgSoAInsert << "\t"
+            << avgCuckooInsert << "\t"
             << avgOpenAddressingRemove << "\t"
             << avgChainingRemove << "\t"
-            << avgAVLRemove << "\n";
+            << avgAVLRemove << "\t"
+            << avgSwissRemove << "\t"
+            << avgRobinHoodRemove << "\t"
+            << avgSoARemove << "\t"
+            << avgCuckooRemove << "\t"
+            << avgOpenAddressingMemory << "\t"
+            << avgSoAMemory << "\t"
+            << avgCuckooMemory << "\t"
+            << avgChainingPoolBytes << "\t"
+            << avgChainingPoolSlabs << "\t"
+            << avgAVLPoolBytes << "\t"
+            << avgAVLPoolSlabs << "\n";
 
         // Wyswietlanie wynikow w konsoli
         cout << "  Wyniki dla rozmiaru " << size << ":" << endl;
         cout << "    Adresowanie otwarte Wstawianie: " << avgOpenAddressingInsert << " ns" << endl;
         cout << "    Lancuchowanie Wstawianie: " << avgChainingInsert << " ns" << endl;
         cout << "    AVL Wstawianie: " << avgAVLInsert << " ns" << endl;
+        cout << "    Swiss Wstawianie: " << avgSwissInsert << " ns" << endl;
+        cout << "    Robin Hood Wstawianie: " << avgRobinHoodInsert << " ns" << endl;
+        cout << "    Adresowanie otwarte SoA Wstawianie: " << avgSoAInsert << " ns" << endl;
+        cout << "    Kukulcze Wstawianie: " << avgCuckooInsert << " ns" << endl;
         cout << "    Adresowanie otwarte Usuwanie: " << avgOpenAddressingRemove << " ns" << endl;
         cout << "    Lancuchowanie Usuwanie: " << avgChainingRemove << " ns" << endl;
         cout << "    AVL Usuwanie: " << avgAVLRemove << " ns" << endl;
+        cout << "    Swiss Usuwanie: " << avgSwissRemove << " ns" << endl;
+        cout << "    Robin Hood Usuwanie: " << avgRobinHoodRemove << " ns" << endl;
+        cout << "    Adresowanie otwarte SoA Usuwanie: " << avgSoARemove << " ns" << endl;
+        cout << "    Kukulcze Usuwanie: " << avgCuckooRemove << " ns" << endl;
+        cout << "    Adresowanie otwarte Pamiec: " << avgOpenAddressingMemory << " B" << endl;
+        cout << "    Adresowanie otwarte SoA Pamiec: " << avgSoAMemory << " B" << endl;
+        cout << "    Kukulcze Pamiec: " << avgCuckooMemory << " B" << endl;
+        cout << "    Lancuchowanie Pula: " << avgChainingPoolBytes << " B w " << avgChainingPoolSlabs << " blokach" << endl;
+        cout << "    AVL Pula: " << avgAVLPoolBytes << " B w " << avgAVLPoolSlabs << " blokach" << endl;
     }
 
     outFile.close();
@@ -174,6 +342,910 @@ void testPerformance() {
     cout << "Calkowity czas pomiaru: " << fullTimeDuration << " minut" << endl;
 }
 
+// Pomiar srednich czasow (ns na operacje) wstawiania, wyszukiwania i usuwania
+// wszystkich kluczy w nowej tablicy typu Table
+template <typename Table>
+void measureBulk(const vector<int>& keys, const vector<int>& values,
+    double& insertTime, double& getTime, double& removeTime) {
+    Table table;
+    int size = (int)keys.size();
+    long long checksum = 0;
+
+    auto start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < size; i++) {
+        table.insert(keys[i], values[i]);
+    }
+    auto end = chrono::high_resolution_clock::now();
+    insertTime += chrono::duration_cast<chrono::nanoseconds>(end - start).count() / (double)size;
+
+    start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < size; i++) {
+        // Odczyt przez const find() - bez sciezki zapisu
+        const int* value = as_const(table).find(keys[i]);
+        if (value != nullptr) {
+            checksum += *value;
+        }
+    }
+    end = chrono::high_resolution_clock::now();
+    getTime += chrono::duration_cast<chrono::nanoseconds>(end - start).count() / (double)size;
+
+    start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < size; i++) {
+        table.remove(keys[i]);
+    }
+    end = chrono::high_resolution_clock::now();
+    removeTime += chrono::duration_cast<chrono::nanoseconds>(end - start).count() / (double)size;
+
+    // Zapobiega usunieciu petli wyszukiwania przez optymalizator
+    if (checksum == -1) {
+        cout << "";
+    }
+}
+
+// Pomiar czterech tablic (AO, lancuchowanie, AVL, hybryda) dla jednej polityki mieszania
+template <typename HashPolicy>
+void testHashPolicy(ofstream& outFile, int size, const char* keyKind,
+    const vector<vector<int>>& keySets, const vector<vector<int>>& valueSets, int rep) {
+    double times[12] = { 0 };
+
+    for (size_t dataSet = 0; dataSet < keySets.size(); dataSet++) {
+        for (int r = 0; r < rep; r++) {
+            measureBulk<HashTableOpenAddressing<int, int, hash<int>, equal_to<int>, HashPolicy>>(keySets[dataSet], valueSets[dataSet], times[0], times[1], times[2]);
+            measureBulk<HashTableChaining<int, int, hash<int>, equal_to<int>, HashPolicy>>(keySets[dataSet], valueSets[dataSet], times[3], times[4], times[5]);
+            measureBulk<HashTableAVL<int, int, hash<int>, less<int>, HashPolicy>>(keySets[dataSet], valueSets[dataSet], times[6], times[7], times[8]);
+            measureBulk<HashTableHybrid<int, int, hash<int>, equal_to<int>, less<int>, HashPolicy>>(keySets[dataSet], valueSets[dataSet], times[9], times[10], times[11]);
+        }
+    }
+
+    int runs = (int)keySets.size() * rep;
+    outFile << size << "\t" << HashPolicy::name() << "\t" << keyKind;
+    for (int i = 0; i < 12; i++) {
+        times[i] /= runs;
+        outFile << "\t" << times[i];
+    }
+    outFile << "\n";
+
+    cout << "    " << HashPolicy::name() << " (" << keyKind << "): "
+        << "AO " << times[0] << "/" << times[1] << "/" << times[2] << " ns, "
+        << "Lancuchowanie " << times[3] << "/" << times[4] << "/" << times[5] << " ns, "
+        << "AVL " << times[6] << "/" << times[7] << "/" << times[8] << " ns, "
+        << "Hybryda " << times[9] << "/" << times[10] << "/" << times[11] << " ns" << endl;
+}
+
+// Opis wzorca kluczy w wynikach
+const char* keyPatternLabel(KeyPattern pattern) {
+    switch (pattern) {
+    case KeyPattern::UNIFORM: return "losowe";
+    case KeyPattern::SEQUENTIAL: return "kolejne";
+    case KeyPattern::STRIDED: return "co pojemnosc";
+    case KeyPattern::CLUSTERED: return "skupione";
+    case KeyPattern::ZIPF: return "Zipf";
+    case KeyPattern::FLOOD: return "atak na Fibonacci";
+    }
+    return "";
+}
+
+// Porownanie polityk mieszania (modulo, Fibonacci, Murmur) dla kluczy
+// z generatorow workload.hpp. Wzorce STRIDED i FLOOD daja dla polityk,
+// w ktore celuja, koszt kwadratowy, wiec sa mierzone tylko do
+// ADVERSARIAL_MAX_SIZE elementow.
+void testHashPolicies() {
+    const int sizes[] = { 10000, 20000, 30000, 40000, 50000, 60000, 70000, 80000, 90000, 100000, 150000, 200000 };
+    const int numSizes = sizeof(sizes) / sizeof(sizes[0]);
+    const int ADVERSARIAL_MAX_SIZE = 20000;
+
+    // Liczba zestawow danych
+    const int n = 5;
+
+    // Liczba powtorzen dla kazdego zestawu danych
+    const int rep = 10;
+
+    ofstream outFile("wyniki_polityki.xlsx");
+    outFile << "Rozmiar\tPolityka\tKlucze\t"
+        << "Adresowanie otwarte Wstawianie (ns)\tAdresowanie otwarte Wyszukiwanie (ns)\tAdresowanie otwarte Usuwanie (ns)\t"
+        << "Lancuchowanie Wstawianie (ns)\tLancuchowanie Wyszukiwanie (ns)\tLancuchowanie Usuwanie (ns)\t"
+        << "AVL Wstawianie (ns)\tAVL Wyszukiwanie (ns)\tAVL Usuwanie (ns)\t"
+        << "Hybryda Wstawianie (ns)\tHybryda Wyszukiwanie (ns)\tHybryda Usuwanie (ns)\n";
+
+    for (int s = 0; s < numSizes; s++) {
+        int size = sizes[s];
+        cout << "Testowanie dla rozmiaru: " << size << endl;
+
+        for (int p = 0; p < NUM_KEY_PATTERNS; p++) {
+            KeyPattern pattern = KEY_PATTERNS[p];
+            bool adversarial = pattern == KeyPattern::STRIDED || pattern == KeyPattern::FLOOD;
+            if (adversarial && size > ADVERSARIAL_MAX_SIZE) {
+                continue;
+            }
+
+            // Te same zestawy danych dla wszystkich polityk i tablic
+            vector<vector<int>> keys(n);
+            vector<vector<int>> values(n);
+            for (int dataSet = 0; dataSet < n; dataSet++) {
+                Dataset dataset = generateDataset(pattern, size, DATA_SEED + dataSet);
+                keys[dataSet] = std::move(dataset.keys);
+                values[dataSet] = std::move(dataset.values);
+            }
+
+            const char* label = keyPatternLabel(pattern);
+            testHashPolicy<ModuloHash>(outFile, size, label, keys, values, rep);
+            testHashPolicy<FibonacciHash>(outFile, size, label, keys, values, rep);
+            testHashPolicy<MurmurHash>(outFile, size, label, keys, values, rep);
+        }
+    }
+
+    outFile.close();
+}
+
+// Pomiar srednich czasow (ns na operacje) operacji wsadowych w porcjach
+// po batchSize kluczy: insertBatch, getBatch i removeBatch wszystkich kluczy
+template <typename Table>
+void measureBatch(const vector<int>& keys, const vector<int>& values, int batchSize,
+    double& insertTime, double& getTime, double& removeTime) {
+    Table table;
+    int size = (int)keys.size();
+    vector<optional<int>> results(batchSize);
+    long long checksum = 0;
+
+    auto start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < size; i += batchSize) {
+        table.insertBatch(&keys[i], &values[i], min(batchSize, size - i));
+    }
+    auto end = chrono::high_resolution_clock::now();
+    insertTime += chrono::duration_cast<chrono::nanoseconds>(end - start).count() / (double)size;
+
+    start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < size; i += batchSize) {
+        checksum += table.getBatch(&keys[i], min(batchSize, size - i), results.data());
+    }
+    end = chrono::high_resolution_clock::now();
+    getTime += chrono::duration_cast<chrono::nanoseconds>(end - start).count() / (double)size;
+
+    start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < size; i += batchSize) {
+        table.removeBatch(&keys[i], min(batchSize, size - i));
+    }
+    end = chrono::high_resolution_clock::now();
+    removeTime += chrono::duration_cast<chrono::nanoseconds>(end - start).count() / (double)size;
+
+    // Zapobiega usunieciu petli wyszukiwania przez optymalizator
+    if (checksum == -1) {
+        cout << "";
+    }
+}
+
+// Operacje wsadowe z pobieraniem z wyprzedzeniem dla roznych rozmiarow
+// wsadu. Kolumna "pojedynczo" to zwykle insert/find/remove.
+void testBatchSizes() {
+    const int sizes[] = { 10000, 50000, 100000, 200000, 500000, 1000000 };
+    const int numSizes = sizeof(sizes) / sizeof(sizes[0]);
+    const int batchSizes[] = { 1, 4, 16, 64, 256 };
+    const int numBatchSizes = sizeof(batchSizes) / sizeof(batchSizes[0]);
+
+    // Liczba zestawow danych
+    const int n = 5;
+
+    // Liczba powtorzen dla kazdego zestawu danych
+    const int rep = 5;
+
+    const char* names[] = { "Adresowanie otwarte", "Lancuchowanie", "AVL" };
+    const char* operations[] = { "Wstawianie", "Wyszukiwanie", "Usuwanie" };
+
+    ofstream outFile("wyniki_wsadowe.xlsx");
+    outFile << "Rozmiar";
+    for (int t = 0; t < 3; t++) {
+        for (int o = 0; o < 3; o++) {
+            outFile << "\t" << names[t] << " " << operations[o] << " pojedynczo (ns)";
+            for (int b = 0; b < numBatchSizes; b++) {
+                outFile << "\t" << names[t] << " " << operations[o] << " wsad " << batchSizes[b] << " (ns)";
+            }
+        }
+    }
+    outFile << "\n";
+
+    for (int s = 0; s < numSizes; s++) {
+        int size = sizes[s];
+        cout << "Testowanie dla rozmiaru: " << size << endl;
+
+        // times[tablica][kolumna][operacja], kolumna 0 - pojedynczo
+        vector<vector<vector<double>>> times(3, vector<vector<double>>(numBatchSizes + 1, vector<double>(3, 0)));
+
+        for (int dataSet = 0; dataSet < n; dataSet++) {
+            generator.setSeed(DATA_SEED + dataSet);
+
+            vector<int> keys(size);
+            vector<int> values(size);
+            for (int i = 0; i < size; i++) {
+                keys[i] = randomInt(1, size * 10);
+                values[i] = randomInt(1, 1000);
+            }
+
+            for (int r = 0; r < rep; r++) {
+                measureBulk<HashTableOpenAddressing<>>(keys, values, times[0][0][0], times[0][0][1], times[0][0][2]);
+                measureBulk<HashTableChaining<>>(keys, values, times[1][0][0], times[1][0][1], times[1][0][2]);
+                measureBulk<HashTableAVL<>>(keys, values, times[2][0][0], times[2][0][1], times[2][0][2]);
+
+                for (int b = 0; b < numBatchSizes; b++) {
+                    vector<double>& oa = times[0][b + 1];
+                    vector<double>& chaining = times[1][b + 1];
+                    vector<double>& avl = times[2][b + 1];
+                    measureBatch<HashTableOpenAddressing<>>(keys, values, batchSizes[b], oa[0], oa[1], oa[2]);
+                    measureBatch<HashTableChaining<>>(keys, values, batchSizes[b], chaining[0], chaining[1], chaining[2]);
+                    measureBatch<HashTableAVL<>>(keys, values, batchSizes[b], avl[0], avl[1], avl[2]);
+                }
+            }
+        }
+
+        int runs = n * rep;
+        outFile << size;
+        for (int t = 0; t < 3; t++) {
+            for (int o = 0; o < 3; o++) {
+                for (int b = 0; b <= numBatchSizes; b++) {
+                    outFile << "\t" << times[t][b][o] / runs;
+                }
+            }
+
+            cout << "    " << names[t] << " wyszukiwanie: pojedynczo " << times[t][0][1] / runs << " ns";
+            for (int b = 0; b < numBatchSizes; b++) {
+                cout << ", wsad " << batchSizes[b] << " " << times[t][b + 1][1] / runs << " ns";
+            }
+            cout << endl;
+        }
+        outFile << "\n";
+    }
+
+    outFile.close();
+}
+
+// Percentyl p (0-100) z posortowanego wektora czasow
+double percentile(const vector<long long>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t index = (size_t)(p / 100.0 * (sorted.size() - 1) + 0.5);
+    return (double)sorted[index];
+}
+
+// Pomiar czasu kazdego pojedynczego wstawienia do tablicy
+template <typename Table>
+void measureInsertLatency(Table& table, const vector<int>& keys, const vector<int>& values,
+    vector<long long>& latencies) {
+    for (size_t i = 0; i < keys.size(); i++) {
+        auto start = chrono::high_resolution_clock::now();
+        table.insert(keys[i], values[i]);
+        auto end = chrono::high_resolution_clock::now();
+        latencies.push_back(chrono::duration_cast<chrono::nanoseconds>(end - start).count());
+    }
+}
+
+// Zapis sredniej, percentyla 99.9 i maksimum opoznien wstawiania
+void reportLatency(ofstream& outFile, const char* name, vector<long long>& latencies) {
+    sort(latencies.begin(), latencies.end());
+
+    double mean = 0;
+    for (size_t i = 0; i < latencies.size(); i++) {
+        mean += latencies[i];
+    }
+    mean /= latencies.size();
+
+    double p999 = percentile(latencies, 99.9);
+    double maxLatency = (double)latencies.back();
+
+    outFile << "\t" << mean << "\t" << p999 << "\t" << maxLatency;
+    cout << "    " << name << ": srednia " << mean << " ns, p99.9 " << p999
+        << " ns, max " << maxLatency << " ns" << endl;
+}
+
+// Opoznienia pojedynczych wstawien przy jednorazowej i przyrostowej
+// zmianie rozmiaru
+void testInsertLatency() {
+    const int sizes[] = { 10000, 20000, 30000, 40000, 50000, 60000, 70000, 80000, 90000, 100000, 150000, 200000 };
+    const int numSizes = sizeof(sizes) / sizeof(sizes[0]);
+
+    // Liczba zestawow danych
+    const int n = 10;
+
+    ofstream outFile("wyniki_opoznienia.xlsx");
+    outFile << "Rozmiar";
+    const char* names[] = { "Adresowanie otwarte", "Adresowanie otwarte przyrostowe",
+        "Lancuchowanie", "Lancuchowanie przyrostowe" };
+    for (int t = 0; t < 4; t++) {
+        outFile << "\t" << names[t] << " Srednia (ns)\t" << names[t] << " p99.9 (ns)\t" << names[t] << " Max (ns)";
+    }
+    outFile << "\n";
+
+    for (int s = 0; s < numSizes; s++) {
+        int size = sizes[s];
+        cout << "Testowanie dla rozmiaru: " << size << endl;
+
+        vector<long long> latencies[4];
+
+        for (int dataSet = 0; dataSet < n; dataSet++) {
+            generator.setSeed(DATA_SEED + dataSet);
+
+            vector<int> keys(size);
+            vector<int> values(size);
+            for (int i = 0; i < size; i++) {
+                keys[i] = randomInt(1, size * 10);
+                values[i] = randomInt(1, 1000);
+            }
+
+            HashTableOpenAddressing<> openAddressing;
+            HashTableOpenAddressing<> openAddressingIncremental = HashTableOpenAddressing<>::incremental();
+            HashTableChaining<> chaining;
+            HashTableChaining<> chainingIncremental = HashTableChaining<>::incremental();
+
+            measureInsertLatency(openAddressing, keys, values, latencies[0]);
+            measureInsertLatency(openAddressingIncremental, keys, values, latencies[1]);
+            measureInsertLatency(chaining, keys, values, latencies[2]);
+            measureInsertLatency(chainingIncremental, keys, values, latencies[3]);
+        }
+
+        outFile << size;
+        for (int t = 0; t < 4; t++) {
+            reportLatency(outFile, names[t], latencies[t]);
+        }
+        outFile << "\n";
+    }
+
+    outFile.close();
+}
+
+// Pomiar czasow (ns) kopii glebokiej, migawki i pierwszego zapisu po migawce
+// dla tablicy z keys.size() elementami. Pierwszy zapis po migawce kopiuje
+// katalog segmentow i jeden segment, wiec jest drozszy od zwyklego.
+template <typename Table>
+void measureSnapshot(const vector<int>& keys, const vector<int>& values,
+    double& copyTime, double& snapshotTime, double& firstWriteTime) {
+    Table table;
+    table.build(keys.data(), values.data(), (int)keys.size());
+
+    auto start = chrono::high_resolution_clock::now();
+    Table copy(table);
+    auto end = chrono::high_resolution_clock::now();
+    copyTime += chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+
+    start = chrono::high_resolution_clock::now();
+    Table snapshot = table.snapshot();
+    end = chrono::high_resolution_clock::now();
+    snapshotTime += chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+
+    start = chrono::high_resolution_clock::now();
+    table.insert(keys[0], values[0] + 1);
+    end = chrono::high_resolution_clock::now();
+    firstWriteTime += chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+
+    // Zapobiega usunieciu kopii przez optymalizator
+    if (copy.getSize() + snapshot.getSize() == -1) {
+        cout << "";
+    }
+}
+
+// Kopia gleboka a migawka copy-on-write (snapshot) dla roznych rozmiarow
+void testSnapshots() {
+    const int sizes[] = { 10000, 50000, 100000, 200000, 500000, 1000000 };
+    const int numSizes = sizeof(sizes) / sizeof(sizes[0]);
+
+    // Liczba zestawow danych
+    const int n = 10;
+
+    const char* names[] = { "Adresowanie otwarte", "Lancuchowanie", "AVL" };
+
+    ofstream outFile("wyniki_migawki.xlsx");
+    outFile << "Rozmiar";
+    for (int t = 0; t < 3; t++) {
+        outFile << "\t" << names[t] << " Kopia (ns)\t" << names[t] << " Migawka (ns)\t" << names[t] << " Pierwszy zapis (ns)";
+    }
+    outFile << "\n";
+
+    for (int s = 0; s < numSizes; s++) {
+        int size = sizes[s];
+        cout << "Testowanie dla rozmiaru: " << size << endl;
+
+        // times[tablica][0 - kopia, 1 - migawka, 2 - pierwszy zapis]
+        double times[3][3] = {};
+
+        for (int dataSet = 0; dataSet < n; dataSet++) {
+            generator.setSeed(DATA_SEED + dataSet);
+
+            vector<int> keys(size);
+            vector<int> values(size);
+            for (int i = 0; i < size; i++) {
+                keys[i] = randomInt(1, size * 10);
+                values[i] = randomInt(1, 1000);
+            }
+
+            measureSnapshot<HashTableOpenAddressing<>>(keys, values, times[0][0], times[0][1], times[0][2]);
+            measureSnapshot<HashTableChaining<>>(keys, values, times[1][0], times[1][1], times[1][2]);
+            measureSnapshot<HashTableAVL<>>(keys, values, times[2][0], times[2][1], times[2][2]);
+        }
+
+        outFile << size;
+        for (int t = 0; t < 3; t++) {
+            outFile << "\t" << times[t][0] / n << "\t" << times[t][1] / n << "\t" << times[t][2] / n;
+            cout << "    " << names[t] << ": kopia " << times[t][0] / n << " ns, migawka " << times[t][1] / n
+                << " ns, pierwszy zapis " << times[t][2] / n << " ns" << endl;
+        }
+        outFile << "\n";
+    }
+
+    outFile.close();
+}
+
+// Sredni czas (ns) wyszukania kazdego klucza z keys[0, count) przez get()
+template <typename Table>
+double timeLookups(const Table& table, const vector<int>& keys, int count, long long& checksum) {
+    auto start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < count; i++) {
+        optional<int> value = table.get(keys[i]);
+        if (value) {
+            checksum += *value;
+        }
+    }
+    auto end = chrono::high_resolution_clock::now();
+    return chrono::duration_cast<chrono::nanoseconds>(end - start).count() / (double)count;
+}
+
+// Pomiar wyszukiwania w tablicy o pojemnosci capacity wypelnionej count
+// kluczami: times[0] - trafienia, times[1] - chybienia, times[2] i times[3]
+// - to samo po churn usunieciach losowych kluczy i wstawieniach nowych
+// (liczba elementow sie nie zmienia). Zwraca false, jesli tablica
+// przy tym wypelnieniu zmienilaby pojemnosc. Wymiana moze zmienic pojemnosc
+// adresowania otwartego, bo nagrobki licza sie do progu.
+template <typename Table>
+bool measureLookups(int capacity, int count, int churn, const vector<int>& keys, const vector<int>& missingKeys,
+    FastRandom& random, double times[4]) {
+    Table table;
+    // Najwieksze zadanie, przy ktorym tablice z progiem 0.7 i 1.0 maja pojemnosc capacity
+    table.reserve((int)(capacity * 0.7));
+
+    vector<int> live(keys.begin(), keys.begin() + count);
+    for (int i = 0; i < count; i++) {
+        table.insert(live[i], i);
+    }
+    if (table.getCapacity() != capacity) {
+        return false;
+    }
+
+    long long checksum = 0;
+    times[0] += timeLookups(table, live, count, checksum);
+    times[1] += timeLookups(table, missingKeys, count, checksum);
+
+    // Wymiana kluczy - w adresowaniu otwartym zostaja nagrobki
+    for (int i = 0; i < churn; i++) {
+        int index = (int)random.nextBelow(count);
+        table.remove(live[index]);
+        live[index] = keys[count + i];
+        table.insert(live[index], i);
+    }
+
+    times[2] += timeLookups(table, live, count, checksum);
+    times[3] += timeLookups(table, missingKeys, count, checksum);
+
+    // Zapobiega usunieciu petli wyszukiwania przez optymalizator
+    if (checksum == -1) {
+        cout << "";
+    }
+    return true;
+}
+
+// Wyszukiwanie (get) przy roznych wspolczynnikach wypelnienia: klucze
+// obecne, nieobecne i oba rodzaje po wymianie tylu kluczy, ile jest
+// w tablicy. Pojemnosc jest stala, wiec wypelnienie zmienia tylko liczba
+// kluczy; adresowanie otwarte nie osiaga wypelnienia powyzej 0.7.
+void testLookups() {
+    const int capacities[] = { 1 << 14, 1 << 17, 1 << 20 };
+    const int numCapacities = sizeof(capacities) / sizeof(capacities[0]);
+    const double loadFactors[] = { 0.25, 0.5, 0.6, 0.69, 0.8, 0.9, 1.0 };
+    const int numLoadFactors = sizeof(loadFactors) / sizeof(loadFactors[0]);
+
+    // Liczba zestawow danych
+    const int n = 3;
+
+    const char* names[] = { "Adresowanie otwarte", "Lancuchowanie", "AVL" };
+    const char* columns[] = { "Trafienia", "Chybienia", "Trafienia po wymianie", "Chybienia po wymianie" };
+
+    ofstream outFile("wyniki_wyszukiwanie.xlsx");
+    outFile << "Pojemnosc\tWypelnienie";
+    for (int t = 0; t < 3; t++) {
+        for (int c = 0; c < 4; c++) {
+            outFile << "\t" << names[t] << " " << columns[c] << " (ns)";
+        }
+    }
+    outFile << "\n";
+
+    for (int c = 0; c < numCapacities; c++) {
+        int capacity = capacities[c];
+
+        for (int l = 0; l < numLoadFactors; l++) {
+            int count = (int)(capacity * loadFactors[l]);
+            cout << "Testowanie dla pojemnosci " << capacity << ", wypelnienie " << loadFactors[l] << endl;
+
+            // times[tablica][kolumna]
+            double times[3][4] = {};
+            bool measured[3] = { true, true, true };
+
+            for (int dataSet = 0; dataSet < n; dataSet++) {
+                // Klucze obecne i wstawiane przy wymianie z [1, range],
+                // nieobecne z (range, 2 * range]
+                FastRandom random(DATA_SEED + dataSet);
+                int range = capacity * 8;
+                vector<int> keys = uniqueKeys(2 * count, 1, range, random);
+                vector<int> missingKeys = uniqueKeys(count, range + 1, 2 * range, random);
+
+                measured[0] = measureLookups<HashTableOpenAddressing<>>(capacity, count, count, keys, missingKeys, random, times[0]) && measured[0];
+                measured[1] = measureLookups<HashTableChaining<>>(capacity, count, count, keys, missingKeys, random, times[1]) && measured[1];
+                measured[2] = measureLookups<HashTableAVL<>>(capacity, count, count, keys, missingKeys, random, times[2]) && measured[2];
+            }
+
+            outFile << capacity << "\t" << loadFactors[l];
+            for (int t = 0; t < 3; t++) {
+                if (!measured[t]) {
+                    outFile << "\t-\t-\t-\t-";
+                    cout << "    " << names[t] << ": wypelnienie nieosiagalne" << endl;
+                    continue;
+                }
+                for (int k = 0; k < 4; k++) {
+                    outFile << "\t" << times[t][k] / n;
+                }
+                cout << "    " << names[t] << ": trafienia " << times[t][0] / n << " ns, chybienia " << times[t][1] / n
+                    << " ns, po wymianie " << times[t][2] / n << " / " << times[t][3] / n << " ns" << endl;
+            }
+            outFile << "\n";
+        }
+    }
+
+    outFile.close();
+}
+
+// Dotychczasowy sposob wspoldzielenia tablicy miedzy watkami - jeden mutex
+// na cala tablice (punkt odniesienia dla tablic wspolbieznych)
+template <typename Table>
+class LockedHashTable {
+private:
+    mutable mutex lock;
+    Table table;
+
+public:
+    void insert(int key, int value) {
+        lock_guard<mutex> guard(lock);
+        table.insert(key, value);
+    }
+
+    bool remove(int key) {
+        lock_guard<mutex> guard(lock);
+        return table.remove(key);
+    }
+
+    optional<int> get(int key) const {
+        lock_guard<mutex> guard(lock);
+        return table.get(key);
+    }
+
+    void reserve(int n) {
+        lock_guard<mutex> guard(lock);
+        table.reserve(n);
+    }
+};
+
+// Przepustowosc (mln operacji na sekunde) threads watkow wykonujacych po
+// opsPerThread operacji na kluczach z [0, keyRange). readPercent procent
+// operacji to wyszukiwania, reszta po rowno wstawienia i usuniecia.
+// Kazdy watek ma wlasny generator xorshift - rand() nie jest bezpieczny
+// dla watkow.
+template <typename Table>
+double measureThroughput(Table& table, int threads, int readPercent, int keyRange, int opsPerThread) {
+    atomic<bool> start(false);
+    atomic<long long> checksum(0);
+    vector<thread> workers;
+
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            unsigned int state = 2463534242u + 7919u * (unsigned int)t;
+            long long found = 0;
+
+            while (!start.load(memory_order_acquire)) {
+                this_thread::yield();
+            }
+
+            for (int i = 0; i < opsPerThread; i++) {
+                state ^= state << 13;
+                state ^= state >> 17;
+                state ^= state << 5;
+                int key = (int)(state % (unsigned int)keyRange);
+                int op = (int)((state >> 8) % 100);
+
+                if (op < readPercent) {
+                    if (table.get(key)) {
+                        found++;
+                    }
+                }
+                else if ((op - readPercent) % 2 == 0) {
+                    table.insert(key, i);
+                }
+                else {
+                    table.remove(key);
+                }
+            }
+
+            checksum += found;
+        });
+    }
+
+    auto begin = chrono::high_resolution_clock::now();
+    start.store(true, memory_order_release);
+    for (size_t t = 0; t < workers.size(); t++) {
+        workers[t].join();
+    }
+    auto end = chrono::high_resolution_clock::now();
+
+    // Zapobiega usunieciu wyszukiwan przez optymalizator
+    if (checksum == -1) {
+        cout << "";
+    }
+
+    double seconds = chrono::duration_cast<chrono::nanoseconds>(end - begin).count() / 1e9;
+    return (double)threads * opsPerThread / seconds / 1e6;
+}
+
+// Tablica wypelniona co drugim kluczem z [0, keyRange)
+template <typename Table>
+void fillHalf(Table& table, int keyRange) {
+    for (int key = 0; key < keyRange; key += 2) {
+        table.insert(key, key);
+    }
+}
+
+// Skalowanie przepustowosci od 1 watku do wszystkich rdzeni dla roznych
+// proporcji odczytow i zapisow: tablice za jednym mutexem, tablica
+// z shardami, tablica bez blokad i drzewa AVL z odczytami bez blokad
+void testConcurrentThroughput() {
+    const int readPercents[] = { 50, 90, 99 };
+    const int numReadPercents = sizeof(readPercents) / sizeof(readPercents[0]);
+    const int keyRange = 1000000;
+    const int opsPerThread = 1000000;
+
+    // Liczba powtorzen dla kazdej konfiguracji
+    const int rep = 3;
+
+    // 1, 2, 4, ... watkow i na koniec wszystkie rdzenie
+    int cores = (int)thread::hardware_concurrency();
+    if (cores < 1) {
+        cores = 1;
+    }
+    vector<int> threadCounts;
+    for (int t = 1; t < cores; t *= 2) {
+        threadCounts.push_back(t);
+    }
+    threadCounts.push_back(cores);
+
+    const char* names[] = { "Lancuchowanie z mutexem", "Lancuchowanie shardy",
+        "Adresowanie otwarte z mutexem", "Adresowanie otwarte bez blokad",
+        "AVL z mutexem", "AVL odczyty bez blokad" };
+    const int numTables = sizeof(names) / sizeof(names[0]);
+
+    ofstream outFile("wyniki_wielowatkowe.xlsx");
+    outFile << "Watki\tOdczyty (%)";
+    for (int t = 0; t < numTables; t++) {
+        outFile << "\t" << names[t] << " (mln op/s)";
+    }
+    outFile << "\n";
+
+    for (size_t c = 0; c < threadCounts.size(); c++) {
+        int threads = threadCounts[c];
+        cout << "Testowanie dla liczby watkow: " << threads << endl;
+
+        for (int r = 0; r < numReadPercents; r++) {
+            double throughput[numTables] = {};
+
+            for (int i = 0; i < rep; i++) {
+                // Tablice wypelnione w polowie zakresu kluczy
+                LockedHashTable<HashTableChaining<>> lockedChaining;
+                ConcurrentHashTableChaining<> shardedChaining;
+                LockedHashTable<HashTableOpenAddressing<>> lockedOpenAddressing;
+                LockFreeHashTableOpenAddressing<> lockFree(keyRange);
+                LockedHashTable<HashTableAVL<>> lockedAVL;
+                ConcurrentHashTableAVL<> concurrentAVL(keyRange);
+                lockedChaining.reserve(keyRange);
+                shardedChaining.reserve(keyRange);
+                lockedOpenAddressing.reserve(keyRange);
+                lockedAVL.reserve(keyRange);
+                fillHalf(lockedChaining, keyRange);
+                fillHalf(shardedChaining, keyRange);
+                fillHalf(lockedOpenAddressing, keyRange);
+                fillHalf(lockFree, keyRange);
+                fillHalf(lockedAVL, keyRange);
+                fillHalf(concurrentAVL, keyRange);
+
+                throughput[0] += measureThroughput(lockedChaining, threads, readPercents[r], keyRange, opsPerThread);
+                throughput[1] += measureThroughput(shardedChaining, threads, readPercents[r], keyRange, opsPerThread);
+                throughput[2] += measureThroughput(lockedOpenAddressing, threads, readPercents[r], keyRange, opsPerThread);
+                throughput[3] += measureThroughput(lockFree, threads, readPercents[r], keyRange, opsPerThread);
+                throughput[4] += measureThroughput(lockedAVL, threads, readPercents[r], keyRange, opsPerThread);
+                throughput[5] += measureThroughput(concurrentAVL, threads, readPercents[r], keyRange, opsPerThread);
+            }
+
+            outFile << threads << "\t" << readPercents[r];
+            cout << "    Odczyty " << readPercents[r] << "%:" << endl;
+            for (int t = 0; t < numTables; t++) {
+                outFile << "\t" << throughput[t] / rep;
+                cout << "      " << names[t] << ": " << throughput[t] / rep << " mln op/s" << endl;
+            }
+            outFile << "\n";
+        }
+    }
+
+    outFile.close();
+}
+
+// Sprawdzenie poprawnosci tablicy wspolbieznej pod obciazeniem threads watkow.
+// Tablice zaczynaja od najmniejszej pojemnosci, wiec w obu fazach wiele razy
+// zmieniaja rozmiar.
+// Faza 1: kazdy watek ma rozlaczne klucze (klucz * threads + numer watku,
+// takze ujemne) i wlasna mape wzorcowa; wynik kazdej operacji porownywany jest
+// z mapa, a na koniec watek sprawdza cala swoja czesc tablicy, podczas gdy
+// pozostale jeszcze pisza. Faza 2: wszystkie watki scigaja sie w emplace na
+// tych samych kluczach - kazdy klucz musi miec dokladnie jednego zwyciezce,
+// ktorego wartosc zostaje w tablicy. Zwraca liczbe bledow.
+template <typename Table>
+long long stressTable(int threads, int opsPerThread, int keysPerThread, int sharedKeys, unsigned long long seed) {
+    long long errors = 0;
+
+    {
+        Table table;
+        vector<unordered_map<int, int>> expected(threads);
+        atomic<long long> mismatches(0);
+        atomic<bool> start(false);
+        vector<thread> workers;
+
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([&, t]() {
+                FastRandom random(seed + (unsigned long long)t);
+                unordered_map<int, int>& mine = expected[t];
+                long long bad = 0;
+
+                while (!start.load(memory_order_acquire)) {
+                    this_thread::yield();
+                }
+
+                for (int i = 0; i < opsPerThread; i++) {
+                    int key = ((int)random.nextBelow(keysPerThread) - keysPerThread / 2) * threads + t;
+                    int op = (int)random.nextBelow(10);
+
+                    if (op < 4) {
+                        int value = (int)random.nextBelow(1000000);
+                        table.insert(key, value);
+                        mine[key] = value;
+                    }
+                    else if (op < 6) {
+                        if (table.remove(key) != (mine.erase(key) == 1)) {
+                            bad++;
+                        }
+                    }
+                    else if (op < 7) {
+                        bool absent = mine.find(key) == mine.end();
+                        if (table.emplace(key, i) != absent) {
+                            bad++;
+                        }
+                        if (absent) {
+                            mine[key] = i;
+                        }
+                    }
+                    else {
+                        optional<int> value = table.get(key);
+                        auto it = mine.find(key);
+                        if (value.has_value() != (it != mine.end()) || (value && *value != it->second)) {
+                            bad++;
+                        }
+                    }
+                }
+
+                for (auto& entry : mine) {
+                    optional<int> value = table.get(entry.first);
+                    if (!value || *value != entry.second) {
+                        bad++;
+                    }
+                }
+                mismatches += bad;
+            });
+        }
+
+        start.store(true, memory_order_release);
+        for (size_t t = 0; t < workers.size(); t++) {
+            workers[t].join();
+        }
+
+        size_t total = 0;
+        for (int t = 0; t < threads; t++) {
+            total += expected[t].size();
+        }
+        errors += mismatches.load();
+        if ((size_t)table.getSize() != total) {
+            errors++;
+        }
+    }
+
+    {
+        Table table;
+        vector<vector<int>> won(threads);
+        atomic<bool> start(false);
+        vector<thread> workers;
+
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([&, t]() {
+                while (!start.load(memory_order_acquire)) {
+                    this_thread::yield();
+                }
+
+                for (int key = 0; key < sharedKeys; key++) {
+                    if (table.emplace(key, t)) {
+                        won[t].push_back(key);
+                    }
+                }
+            });
+        }
+
+        start.store(true, memory_order_release);
+        for (size_t t = 0; t < workers.size(); t++) {
+            workers[t].join();
+        }
+
+        vector<int> winner(sharedKeys, -1);
+        for (int t = 0; t < threads; t++) {
+            for (int key : won[t]) {
+                if (winner[key] != -1) {
+                    errors++;
+                }
+                winner[key] = t;
+            }
+        }
+        for (int key = 0; key < sharedKeys; key++) {
+            optional<int> value = table.get(key);
+            if (winner[key] == -1 || !value || *value != winner[key]) {
+                errors++;
+            }
+        }
+        if (table.getSize() != sharedKeys) {
+            errors++;
+        }
+    }
+
+    return errors;
+}
+
+// Test poprawnosci tablic wspolbieznych (stressTable) w kilku rundach
+// z roznymi ziarnami - co najmniej 8 watkow, takze na maszynie z mniejsza
+// liczba rdzeni (przeplot zapewnia wtedy planista)
+void testConcurrentStress() {
+    const int opsPerThread = 300000;
+    const int keysPerThread = 5000;
+    const int sharedKeys = 200000;
+    const int rounds = 3;
+
+    int threads = max(8, (int)thread::hardware_concurrency());
+    const char* names[] = { "Lancuchowanie shardy", "Adresowanie otwarte bez blokad", "AVL odczyty bez blokad" };
+    const int numTables = sizeof(names) / sizeof(names[0]);
+    long long errors[numTables] = {};
+
+    cout << "Watki: " << threads << ", rundy: " << rounds << endl;
+    for (int r = 0; r < rounds; r++) {
+        unsigned long long seed = DATA_SEED + 1000 * (unsigned long long)r;
+        errors[0] += stressTable<ConcurrentHashTableChaining<>>(threads, opsPerThread, keysPerThread, sharedKeys, seed);
+        errors[1] += stressTable<LockFreeHashTableOpenAddressing<>>(threads, opsPerThread, keysPerThread, sharedKeys, seed);
+        errors[2] += stressTable<ConcurrentHashTableAVL<>>(threads, opsPerThread, keysPerThread, sharedKeys, seed);
+    }
+
+    for (int t = 0; t < numTables; t++) {
+        cout << "    " << names[t] << ": ";
+        if (errors[t] == 0) {
+            cout << "OK" << endl;
+        }
+        else {
+            cout << "BLEDY: " << errors[t] << endl;
+        }
+    }
+}
+
 // Menu glowne
 void mainMenu() {
     int choice;
@@ -182,6 +1254,13 @@ void mainMenu() {
     while (!exit) {
         cout << "\n=== MENU GLOWNE ===" << endl;
         cout << "1. Rozpoczecie pomiarow wydajnosci" << endl;
+        cout << "2. Porownanie polityk mieszania" << endl;
+        cout << "3. Opoznienia wstawiania (przyrostowa zmiana rozmiaru)" << endl;
+        cout << "4. Operacje wsadowe (rozne rozmiary wsadu)" << endl;
+        cout << "5. Kopia a migawka (copy-on-write)" << endl;
+        cout << "6. Przepustowosc wielowatkowa (shardy, bez blokad, AVL z epokami)" << endl;
+        cout << "7. Wyszukiwanie: trafienia, chybienia, po wymianie kluczy" << endl;
+        cout << "8. Poprawnosc wielowatkowa (mapy wzorcowe, wyscig emplace)" << endl;
         cout << "0. Wyjscie" << endl;
         cout << "Wybierz opcje: ";
         cin >> choice;
@@ -190,6 +1269,27 @@ void mainMenu() {
         case 1:
             testPerformance();
             break;
+        case 2:
+            testHashPolicies();
+            break;
+        case 3:
+            testInsertLatency();
+            break;
+        case 4:
+            testBatchSizes();
+            break;
+        case 5:
+            testSnapshots();
+            break;
+        case 6:
+            testConcurrentThroughput();
+            break;
+        case 7:
+            testLookups();
+            break;
+        case 8:
+            testConcurrentStress();
+            break;
         case 0:
             exit = true;
             break;
@@ -204,6 +1304,14 @@ int main() {
     cout << "1. Tablica mieszajaca z adresowaniem otwartym" << endl;
     cout << "2. Tablica mieszajaca z lancuchowaniem (listy powiazane)" << endl;
     cout << "3. Tablica mieszajaca z lancuchowaniem (drzewa AVL)" << endl;
+    cout << "4. Tablica mieszajaca z adresowaniem otwartym (Swiss, grupy SSE2)" << endl;
+    cout << "5. Tablica mieszajaca z adresowaniem otwartym (Robin Hood)" << endl;
+    cout << "6. Tablica mieszajaca z adresowaniem otwartym (struktura tablic)" << endl;
+    cout << "7. Wspolbiezna tablica mieszajaca z lancuchowaniem (shardy)" << endl;
+    cout << "8. Tablica mieszajaca z adresowaniem otwartym bez blokad (klucze int)" << endl;
+    cout << "9. Wspolbiezna tablica mieszajaca z drzewami AVL (odczyty bez blokad)" << endl;
+    cout << "10. Tablica mieszajaca z lancuchowaniem hybrydowym (listy zamieniane w drzewa AVL)" << endl;
+    cout << "11. Tablica mieszajaca kukulcza (kubelki 4-miejscowe, dwa kubelki na klucz, SSE2)" << endl;
 
     mainMenu();
 
@@ -2,150 +2,549 @@
 #define AVL_HPP
 
 #include <iostream>
+#include <algorithm>
+#include <memory>
 #include "avl_tree.hpp"
+#include "hash_policy.hpp"
+#include "prefetch.hpp"
+#include "cow_array.hpp"
+#include "table_stats.hpp"
+#include <functional>
+#include <optional>
+#include <type_traits>
 #include <vector>
 #include <utility>
 
 using namespace std;
 
 // Tablica mieszajaca z lancuchowaniem wykorzystujaca drzewa AVL
+// K, V - typy klucza i wartosci
+// Hash - funkcja skrotu, Compare - porzadek kluczy w drzewach kubelkow
+// HashPolicy - polityka mieszania z hash_policy.hpp
+// Bucket - struktura kubelka: AVLTree albo inna o tym samym interfejsie
+// (np. SortedArrayBucket z sorted_bucket.hpp, CompactAVLTree z compact_avl_tree.hpp)
+// Drzewa kubelkow leza w CowArray, wiec snapshot() kosztuje O(1), a zapisy
+// po migawce kopiuja tylko segmenty drzew, ktore zmieniaja. Tablica, z ktorej
+// przeniesiono zawartosc, nie ma kubelkow ani puli (pojemnosc 0) - dostaje
+// je przy pierwszym wstawieniu.
+template <typename K = int, typename V = int, typename Hash = hash<K>,
+    typename Compare = less<K>, typename HashPolicy = FibonacciHash, typename Bucket = AVLTree<K, V, Compare>>
 class HashTableAVL {
 private:
-    AVLTree* table;
+    typedef Bucket Tree;
+    typedef typename Tree::Pool Pool;
+
+    // Operacje na kubelkach dla CowArray: kopia kubelka kopiuje drzewo,
+    // zwolnienie kubelka oddaje wezly drzewa do puli
+    struct TreeOps {
+        Pool* pool;
+
+        TreeOps() : pool(nullptr) {}
+        explicit TreeOps(Pool* nodePool) : pool(nodePool) {}
+
+        void copy(const Tree& from, Tree& to) {
+            to.setPool(pool);
+            copyTree(from, to);
+        }
+
+        void destroy(Tree& tree) {
+            tree.clear();
+        }
+    };
+
+    typedef CowArray<Tree, TreeOps> Buckets;
+
+    shared_ptr<Pool> pool;   // wspolna dla tablicy i jej migawek
+    Buckets table;
     int capacity;
     int size;
     const double LOAD_FACTOR_THRESHOLD = 1.0;
+    Hash hasher;
+    HashPolicy policy;
+
+#ifdef HASH_TABLE_STATS
+    ResizeCounters counters;
+#endif
+
+    // Indeks kubelka dla klucza
+    int hash(const K& key) const {
+        return policy(hasher(key));
+    }
+
+    // Wspolna czesc konstruktorow - nowa pula i initialCapacity pustych kubelkow
+    void init(int initialCapacity) {
+        pool = make_shared<Pool>();
+        capacity = initialCapacity;
+        size = 0;
+        createTable(table, capacity);
+        policy.setCapacity(capacity);
+    }
+
+    // Zwiekszenie pojemnosci po przekroczeniu progu wypelnienia
+    // (tablica po przeniesieniu zawartosci dostaje pierwsze kubelki)
+    void grow() {
+        if (capacity == 0) {
+            init(16);
+        }
+        else {
+            resize(capacity * 2);
+        }
+    }
+
+    // Utworzenie tablicy pustych drzew korzystajacych z puli wezlow tablicy
+    void createTable(Buckets& trees, int tableCapacity) {
+        trees.setOps(TreeOps(pool.get()));
+        trees.allocate(tableCapacity);
+        for (int i = 0; i < tableCapacity; i++) {
+            trees.write(i).setPool(pool.get());
+        }
+    }
+
+    // Skopiowanie par jednego drzewa do drugiego (pustego); pary przychodza
+    // posortowane, wiec kopia jest budowana w czasie liniowym
+    static void copyTree(const Tree& from, Tree& to) {
+        // Niekopiowalne wartosci nigdy nie sa kopiowane (brak migawek i kopii)
+        if constexpr (is_copy_constructible<V>::value) {
+            from.forEach([&](const K& key, const V& value) {
+                to.pushSorted(key, value);
+            });
+            to.finishSorted();
+        }
+    }
+
+    // Porzucenie wszystkich drzew. Gdy pula nie jest dzielona z migawka,
+    // a wezly maja trywialny destruktor, wezly sa zwalniane naraz z cala pula.
+    void releaseTable() {
+        if (pool.use_count() == 1 && is_trivially_destructible<K>::value && is_trivially_destructible<V>::value) {
+            table.release(false);
+            pool->releaseAll();
+        }
+        else {
+            table.release();
+        }
+    }
+
+    // Drzewo kubelka index do zmiany - segment wspoldzielony z migawka jest
+    // kopiowany tylko wtedy, gdy klucz jest w drzewie
+    Tree* findTreeForWrite(int index, const K& key) {
+        if (table[index].find(key) == nullptr) {
+            return nullptr;
+        }
+        return &table.write(index);
+    }
+
+    // Pierwsze dwa etapy operacji wsadowej dla porcji kluczy [start, end):
+    // policzenie indeksow i pobranie drzew kubelkow, a potem ich korzeni
+    void prefetchBuckets(const K* keys, int start, int end, int* indices) const {
+        for (int i = start; i < end; i++) {
+            indices[i - start] = hash(keys[i]);
+            prefetchRead(&table[indices[i - start]]);
+        }
+
+        for (int i = start; i < end; i++) {
+            table[indices[i - start]].prefetchRoot();
+        }
+    }
 
-    // Prosta funkcja mieszajaca
-    int hash(int key) {
-        return abs(key) % capacity;
+    // Najmniejsza pojemnosc (potega dwojki, co najmniej 16), przy ktorej
+    // expectedSize elementow nie przekracza progu wypelnienia
+    int capacityFor(int expectedSize) const {
+        int newCapacity = 16;
+        while (expectedSize > newCapacity * LOAD_FACTOR_THRESHOLD) {
+            newCapacity *= 2;
+        }
+        return newCapacity;
     }
 
     // Zmiana rozmiaru tablicy gdy wspolczynnik wypelnienia przekroczy prog
-    void resize() {
+    // (albo na zadanie reserve)
+    void resize(int newCapacity) {
+#ifdef HASH_TABLE_STATS
+        counters.resizes++;
+        RehashTimer timer(counters);
+#endif
+
         int oldCapacity = capacity;
-        AVLTree* oldTable = table;
+        Buckets oldTable = std::move(table);
 
-        capacity *= 2;                    // Podwajamy rozmiar
-        table = new AVLTree[capacity];    // Nowa tablica
-        size = 0;                         // Resetujemy size
+        capacity = newCapacity;           // Zwykle podwajamy rozmiar
+        createTable(table, capacity);     // Nowa tablica
+        policy.setCapacity(capacity);     // Nowa funkcja hash
 
         // Przechodzimy przez kady kubeek starej tablicy
         for (int i = 0; i < oldCapacity; i++) {
-            vector<pair<int, int>> pairs;
-            oldTable[i].getAllPairs(pairs);  // Pobieramy wszystkie pary z drzewa AVL
+            if (oldTable[i].getSize() == 0) {
+                continue;
+            }
 
-            // Kazda para do nowej tablicy
-            for (const auto& p : pairs) {
-                insert(p.first, p.second);   // Nowa funkcja hash
+            // Drzewo kazdego kubelka rozpada sie rosnaco na podciagi nowych kubelkow
+            // (przy podwajaniu dokladnie dwa, wedlug kolejnego bitu skrotu), z ktorych
+            // finishSorted() buduje drzewa w czasie liniowym. Wezly sa przepinane bez
+            // kopiowania, chyba ze kubelek jest wspoldzielony z migawka - wtedy pary
+            // sa kopiowane, zeby nie kopiowac calego segmentu starej tablicy.
+            auto target = [&](const K& key) -> Tree& {
+                return table.write(hash(key));   // Nowa funkcja hash
+            };
+            if (oldTable.isShared(i)) {
+                copyPairsTo(oldTable[i], target);
+            }
+            else {
+                oldTable.write(i).distribute(target);
             }
         }
 
-        delete[] oldTable;
+        for (int i = 0; i < capacity; i++) {
+            if (table[i].getSize() > 0) {
+                table.write(i).finishSorted();
+            }
+        }
     }
 
-public:
-    HashTableAVL() {
-        capacity = 16;
-        size = 0;
-        table = new AVLTree[capacity];
+    // Skopiowanie par drzewa do budowanych drzew target(key)
+    template <typename Target>
+    static void copyPairsTo(const Tree& from, Target target) {
+        if constexpr (is_copy_constructible<V>::value) {
+            from.forEach([&](const K& key, const V& value) {
+                target(key).pushSorted(key, value);
+            });
+        }
     }
 
-    // Konstruktor kopiujcy
-    HashTableAVL(const HashTableAVL& other) {
+    // Skopiowanie zawartosci innej tablicy; kopia dostaje wlasna pule wezlow
+    void copyFrom(const HashTableAVL& other) {
+        pool = make_shared<Pool>();
         capacity = other.capacity;
         size = other.size;
-        table = new AVLTree[capacity];
+        createTable(table, capacity);
+        hasher = other.hasher;
+        policy = other.policy;
+
+        // Pula z indeksami zamiast wskaznikow (arena CompactAVLTree) jest
+        // kopiowana w calosci, a drzewa przejmuja tylko korzenie - o ile nie
+        // dzieli jej migawka, ktorej wezlow kopia by nie potrzebowala
+        if constexpr (is_copy_assignable<Pool>::value && is_copy_constructible<V>::value) {
+            if (other.pool.use_count() == 1) {
+                *pool = *other.pool;
+                for (int i = 0; i < capacity; i++) {
+                    if (other.table[i].getSize() > 0) {
+                        table.write(i).copyRoot(other.table[i]);
+                    }
+                }
+                return;
+            }
+        }
 
         for (int i = 0; i < capacity; i++) {
             // Skopiuj kade drzewo AVL
-            vector<pair<int, int>> pairs;
-            other.table[i].getAllPairs(pairs);
-
-            for (const auto& p : pairs) {
-                table[i].insert(p.first, p.second);
+            if (other.table[i].getSize() > 0) {
+                copyTree(other.table[i], table.write(i));
             }
         }
     }
 
+    // Przejecie zawartosci innej tablicy; tamta zostaje pusta, bez kubelkow
+    // i puli (bez przydzialu pamieci - dostanie je przy pierwszym wstawieniu)
+    void moveFrom(HashTableAVL& other) noexcept {
+        pool = std::move(other.pool);
+        table = std::move(other.table);
+        capacity = other.capacity;
+        size = other.size;
+        hasher = std::move(other.hasher);
+        policy = other.policy;
+
+        other.capacity = 0;
+        other.size = 0;
+    }
+
+    // Znacznik konstruktora migawki
+    struct SnapshotTag {};
+
+    // Migawka - wszystkie pola kopiowane, pula i segmenty drzew wspoldzielone
+    HashTableAVL(const HashTableAVL& other, SnapshotTag)
+        : pool(other.pool), table(other.table), capacity(other.capacity), size(other.size),
+        hasher(other.hasher), policy(other.policy) {}
+
+public:
+    HashTableAVL() {
+        init(16);
+    }
+
+    // Tablica od razu dopasowana do expectedSize elementow
+    explicit HashTableAVL(int expectedSize) {
+        init(capacityFor(expectedSize));
+    }
+
+    // Konstruktor kopiujcy
+    HashTableAVL(const HashTableAVL& other) {
+        copyFrom(other);
+    }
+
+    // Konstruktor przenoszacy
+    HashTableAVL(HashTableAVL&& other) noexcept {
+        moveFrom(other);
+    }
+
     // Operator przypisania
     HashTableAVL& operator=(const HashTableAVL& other) {
         if (this != &other) {
-            delete[] table;
-
-            capacity = other.capacity;
-            size = other.size;
-            table = new AVLTree[capacity];
-
-            for (int i = 0; i < capacity; i++) {
-                vector<pair<int, int>> pairs;
-                other.table[i].getAllPairs(pairs);
+            releaseTable();
+            copyFrom(other);
+        }
+        return *this;
+    }
 
-                for (const auto& p : pairs) {
-                    table[i].insert(p.first, p.second);
-                }
-            }
+    // Przenoszacy operator przypisania
+    HashTableAVL& operator=(HashTableAVL&& other) noexcept {
+        if (this != &other) {
+            releaseTable();
+            moveFrom(other);
         }
         return *this;
     }
 
     ~HashTableAVL() {
-        delete[] table;
+        releaseTable();
+    }
+
+    // Migawka tablicy w czasie O(1). Migawka i oryginal dziela segmenty drzew
+    // i pule wezlow; pierwszy zapis do segmentu (w dowolnej z nich) kopiuje
+    // tylko drzewa tego segmentu. Migawke mozna czytac z innego watku, ale
+    // tworzyc i niszczyc tylko w watku, ktory zapisuje do oryginalu
+    // (z kubelkami CompactAVLTree takze czytac, bo wzrost areny przenosi wezly).
+    HashTableAVL snapshot() const {
+        static_assert(is_copy_constructible<V>::value, "snapshot() wymaga kopiowalnych wartosci");
+        return HashTableAVL(*this, SnapshotTag());
     }
 
-    // Wstawianie pary klucz-wartosc
-    void insert(int key, int value) {
+    // Wstawianie pary klucz-wartosc (istniejaca wartosc jest nadpisywana)
+    void insert(const K& key, V value) {
         // Sprawdzenie czy potrzebna jest zmiana rozmiaru
-        if ((double)size / capacity >= LOAD_FACTOR_THRESHOLD) {
-            resize();
+        // (przy pojemnosci 0 warunek jest zawsze spelniony)
+        if (size >= capacity * LOAD_FACTOR_THRESHOLD) {
+            grow();
         }
 
-        int index = hash(key);
-
-        // Sprawdzenie czy klucz juz istnieje
-        int oldValue = table[index].get(key);
-        if (oldValue == -1) {
-            // Klucz nie istnieje, zwieksz rozmiar
+        // Drzewo zglasza, czy klucz byl nowy - bez osobnego wyszukiwania
+        if (table.write(hash(key)).insert(key, std::move(value))) {
             size++;
         }
+    }
+
+    // Wstawienie wartosci zbudowanej z args, jesli klucza nie ma w tablicy.
+    // Zwraca true, jesli klucz zostal dodany.
+    template <typename... Args>
+    bool emplace(const K& key, Args&&... args) {
+        if (size >= capacity * LOAD_FACTOR_THRESHOLD) {
+            grow();
+        }
 
-        table[index].insert(key, value);
+        int index = hash(key);
+        if (table[index].find(key) != nullptr) {
+            return false;
+        }
+
+        table.write(index).emplace(key, std::forward<Args>(args)...);
+        size++;
+        return true;
     }
 
     // Usuwanie pary klucz-wartosc
-    bool remove(int key) {
+    bool remove(const K& key) {
+        if (capacity == 0) {
+            return false;
+        }
+
         int index = hash(key);
 
-        bool removed = table[index].remove(key);
-        if (removed) {
-            size--;
+        Tree* tree = findTreeForWrite(index, key);
+        if (tree == nullptr) {
+            return false;
         }
 
-        return removed;
+        tree->remove(key);
+        size--;
+        return true;
     }
 
-    // Pobieranie wartosci dla klucza
-    int get(int key) {
-        int index = hash(key);
-        return table[index].get(key);
+    // Wskaznik na wartosc dla klucza (nullptr gdy brak). Wartosc moze byc
+    // zmieniana, wiec gdy klucz jest w segmencie wspoldzielonym z migawka,
+    // segment jest najpierw kopiowany. Sam odczyt powinien isc przez const
+    // find() albo get(), ktore niczego nie kopiuja.
+    V* find(const K& key) {
+        if (capacity == 0) {
+            return nullptr;
+        }
+
+        Tree* tree = findTreeForWrite(hash(key), key);
+        return tree != nullptr ? tree->find(key) : nullptr;
+    }
+
+    const V* find(const K& key) const {
+        if (capacity == 0) {
+            return nullptr;
+        }
+        return table[hash(key)].find(key);
+    }
+
+    // Pobieranie kopii wartosci dla klucza
+    optional<V> get(const K& key) const {
+        const V* value = find(key);
+        if (value == nullptr) {
+            return nullopt;
+        }
+        return *value;
+    }
+
+    // Dopasowanie pojemnosci tak, zeby n elementow miescilo sie bez zmiany
+    // rozmiaru. Tablica nigdy sie nie zmniejsza.
+    void reserve(int n) {
+        if (capacity == 0) {
+            init(capacityFor(n));
+            return;
+        }
+
+        int newCapacity = capacityFor(n);
+        if (newCapacity > capacity) {
+            resize(newCapacity);
+        }
+    }
+
+    // Wstawienie count par (keys[i], values[i]) z jednorazowym dopasowaniem
+    // pojemnosci - bez sprawdzania progu przy kazdym wstawieniu
+    void build(const K* keys, const V* values, int count) {
+        reserve(size + count);
+
+        for (int i = 0; i < count; i++) {
+            if (table.write(hash(keys[i])).insert(keys[i], values[i])) {
+                size++;
+            }
+        }
+    }
+
+    // Wsadowe wstawianie count par (keys[i], values[i]).
+    // Indeks jest liczony w insert ponownie, bo wstawienie moze zmienic
+    // rozmiar tablicy - pobrane kubelki przyspieszaja wtedy tylko reszte porcji.
+    void insertBatch(const K* keys, const V* values, int count) {
+        if (capacity == 0) {
+            init(16);
+        }
+
+        int indices[BATCH_BLOCK];
+
+        for (int start = 0; start < count; start += BATCH_BLOCK) {
+            int end = min(start + BATCH_BLOCK, count);
+            prefetchBuckets(keys, start, end, indices);
+
+            for (int i = start; i < end; i++) {
+                insert(keys[i], values[i]);
+            }
+        }
+    }
+
+    // Wsadowe wyszukiwanie count kluczy; results[i] dostaje kopie wartosci
+    // albo nullopt. Zwraca liczbe znalezionych kluczy.
+    int getBatch(const K* keys, int count, optional<V>* results) const {
+        if (capacity == 0) {
+            fill(results, results + count, nullopt);
+            return 0;
+        }
+
+        int indices[BATCH_BLOCK];
+        int found = 0;
+
+        for (int start = 0; start < count; start += BATCH_BLOCK) {
+            int end = min(start + BATCH_BLOCK, count);
+            prefetchBuckets(keys, start, end, indices);
+
+            for (int i = start; i < end; i++) {
+                const V* value = table[indices[i - start]].find(keys[i]);
+                if (value != nullptr) {
+                    results[i] = *value;
+                    found++;
+                }
+                else {
+                    results[i] = nullopt;
+                }
+            }
+        }
+
+        return found;
+    }
+
+    // Wsadowe usuwanie count kluczy. Zwraca liczbe usunietych kluczy.
+    int removeBatch(const K* keys, int count) {
+        if (capacity == 0) {
+            return 0;
+        }
+
+        int indices[BATCH_BLOCK];
+        int removed = 0;
+
+        for (int start = 0; start < count; start += BATCH_BLOCK) {
+            int end = min(start + BATCH_BLOCK, count);
+            prefetchBuckets(keys, start, end, indices);
+
+            for (int i = start; i < end; i++) {
+                Tree* tree = findTreeForWrite(indices[i - start], keys[i]);
+                if (tree != nullptr) {
+                    tree->remove(keys[i]);
+                    size--;
+                    removed++;
+                }
+            }
+        }
+
+        return removed;
     }
 
     // Czyszczenie tablicy mieszajacej
     void clear() {
-        for (int i = 0; i < capacity; i++) {
-            table[i].clear();
+        releaseTable();
+
+        if (pool == nullptr) {
+            init(16);
+            return;
         }
 
-        delete[] table;
         capacity = 16;
         size = 0;
-        table = new AVLTree[capacity];
+        createTable(table, capacity);
+        policy.setCapacity(capacity);
     }
 
     // Pobieranie aktualnego rozmiaru
-    int getSize() {
+    int getSize() const {
         return size;
     }
+
+    // Pojemnosc tablicy (liczba kubelkow)
+    int getCapacity() const {
+        return capacity;
+    }
+
+    // Statystyki struktury: rozklad wysokosci i liczby elementow drzew
+    // w kubelkach (razem z pustymi)
+    TableStats getStats() const {
+        TableStats stats;
+        stats.size = size;
+        stats.capacity = capacity;
+        stats.nodeBytes = pool != nullptr ? pool->getStats().bytes : 0;
+
+        for (int i = 0; i < capacity; i++) {
+            stats.treeHeights.add(table[i].getHeight());
+            stats.treeSizes.add(table[i].getSize());
+        }
+
+#ifdef HASH_TABLE_STATS
+        counters.fill(stats);
+#endif
+        return stats;
+    }
+
+    // Statystyki puli wezlow
+    PoolStats getPoolStats() const {
+        return pool != nullptr ? pool->getStats() : PoolStats();
+    }
 };
 
 #endif
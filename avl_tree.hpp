@@ -3,301 +3,506 @@
 
 #include <iostream>
 #include <algorithm>
+#include <functional>
 #include <vector>
 #include <utility>
+#include <type_traits>
+#include <cstdint>
+#include "node_pool.hpp"
+#include "prefetch.hpp"
 
 using namespace std;
 
 // Prosta implementacja drzewa AVL
+// Operacje sa iteracyjne (jawna sciezka zamiast rekurencji), a wezel
+// przechowuje tylko wspolczynnik zbalansowania zamiast pelnej wysokosci
+// K, V - typy klucza i wartosci, Compare - porzadek kluczy
+template <typename K = int, typename V = int, typename Compare = less<K>>
 class AVLTree {
 private:
     // Struktura wezla dla drzewa AVL
     struct Node {
-        int key;
-        int value;
+        K key;
+        V value;
         Node* left;
         Node* right;
-        int height;
+        int8_t balance;   // wysokosc lewego poddrzewa minus wysokosc prawego (-1, 0, 1)
 
-        Node(int k, int v) : key(k), value(v), left(nullptr), right(nullptr), height(1) {}
+        template <typename... Args>
+        Node(const K& k, Args&&... args) : key(k), value(std::forward<Args>(args)...), left(nullptr), right(nullptr), balance(0) {}
     };
 
+public:
+    // Pula wezlow wspolna dla wszystkich drzew jednej tablicy
+    typedef NodePool<Node> Pool;
+
+private:
     Node* root;
     int size;
-
-    // Pobieranie wysokosci wezla
-    int height(Node* node) {
-        if (node == nullptr) {
-            return 0;
+    Pool* pool;   // nullptr - wezly przydzielane przez new/delete
+    Compare compare;
+
+    // Przydzielenie nowego wezla
+    template <typename... Args>
+    Node* newNode(const K& key, Args&&... args) {
+        if (pool != nullptr) {
+            return pool->allocate(key, std::forward<Args>(args)...);
         }
-        return node->height;
+        return new Node(key, std::forward<Args>(args)...);
     }
 
-    // Pobieranie wspolczynnika zbalansowania wezla
-    int getBalance(Node* node) {
-        if (node == nullptr) {
-            return 0;
+    // Zwolnienie wezla
+    void freeNode(Node* node) {
+        if (pool != nullptr) {
+            pool->deallocate(node);
+        }
+        else {
+            delete node;
         }
-        return height(node->left) - height(node->right);
     }
 
-    // Rotacja w prawo
-    Node* rightRotate(Node* y) {
-        Node* x = y->left;
-        Node* T2 = x->right;
+    // Najwieksza wysokosc drzewa AVL o co najwyzej 2^31 wezlach to 45
+    // (h < 1.44 * log2(n + 2)); tyle miejsca wystarcza na sciezke od korzenia
+    static const int MAX_HEIGHT = 48;
 
-        // Wykonanie rotacji
+    // Rotacja w prawo; zwraca nowy korzen poddrzewa.
+    // Wspolczynniki sa przeliczane bez znajomosci wysokosci poddrzew.
+    static Node* rightRotate(Node* y) {
+        Node* x = y->left;
+        y->left = x->right;
         x->right = y;
-        y->left = T2;
-
-        // Aktualizacja wysokosci
-        y->height = max(height(y->left), height(y->right)) + 1;
-        x->height = max(height(x->left), height(x->right)) + 1;
 
+        y->balance = (int8_t)(y->balance - 1 - max<int>(x->balance, 0));
+        x->balance = (int8_t)(x->balance - 1 + min<int>(y->balance, 0));
         return x;
     }
 
     // Rotacja w lewo
-    Node* leftRotate(Node* x) {
+    static Node* leftRotate(Node* x) {
         Node* y = x->right;
-        Node* T2 = y->left;
-
-        // Wykonanie rotacji
+        x->right = y->left;
         y->left = x;
-        x->right = T2;
-
-        // Aktualizacja wysokosci
-        x->height = max(height(x->left), height(x->right)) + 1;
-        y->height = max(height(y->left), height(y->right)) + 1;
 
+        x->balance = (int8_t)(x->balance + 1 - min<int>(y->balance, 0));
+        y->balance = (int8_t)(y->balance + 1 + max<int>(x->balance, 0));
         return y;
     }
 
-    // Wstawianie wezla do drzewa AVL
-    Node* insertNode(Node* node, int key, int value) {
-        // Wykonanie standardowego wstawiania BST
-        if (node == nullptr) {
-            size++;
-            return new Node(key, value);
+    // Przywrocenie zbalansowania wezla o wspolczynniku +-2
+    static Node* rebalance(Node* node) {
+        if (node->balance > 0) {
+            // Przypadek Lewy-Prawy sprowadzany do Lewy-Lewy
+            if (node->left->balance < 0) {
+                node->left = leftRotate(node->left);
+            }
+            return rightRotate(node);
         }
 
-        if (key < node->key) {
-            node->left = insertNode(node->left, key, value);
-        }
-        else if (key > node->key) {
-            node->right = insertNode(node->right, key, value);
-        }
-        else {
-            // Klucz juz istnieje, aktualizacja wartosci
-            node->value = value;
-            return node;
+        // Przypadek Prawy-Lewy sprowadzany do Prawy-Prawy
+        if (node->right->balance > 0) {
+            node->right = rightRotate(node->right);
         }
+        return leftRotate(node);
+    }
 
-        // Aktualizacja wysokosci biezacego wezla
-        node->height = 1 + max(height(node->left), height(node->right));
-
-        // Pobranie wspolczynnika zbalansowania
-        int balance = getBalance(node);
-
-        // Przypadek Lewy-Lewy
-        if (balance > 1 && key < node->left->key) {
-            return rightRotate(node);
+    // Zejscie od korzenia do miejsca klucza. path - adresy wskaznikow na
+    // kolejne wezly, depth - ich liczba. Zwraca adres wskaznika, ktory
+    // wskazuje wezel z kluczem albo jest pusty (tam trafia nowy wezel).
+    Node** findLink(const K& key, Node** path[], int& depth) {
+        depth = 0;
+        Node** link = &root;
+        while (*link != nullptr) {
+            Node* node = *link;
+            if (compare(key, node->key)) {
+                path[depth++] = link;
+                link = &node->left;
+            }
+            else if (compare(node->key, key)) {
+                path[depth++] = link;
+                link = &node->right;
+            }
+            else {
+                break;
+            }
         }
+        return link;
+    }
 
-        // Przypadek Prawy-Prawy
-        if (balance < -1 && key > node->right->key) {
-            return leftRotate(node);
-        }
+    // Powrot w gore sciezki po dolaczeniu liscia child, dopoki wysokosc poddrzewa rosnie
+    void retraceInsert(Node** path[], int depth, Node* child) {
+        for (int i = depth - 1; i >= 0; i--) {
+            Node* node = *path[i];
+            node->balance += node->left == child ? 1 : -1;
 
-        // Przypadek Lewy-Prawy
-        if (balance > 1 && key > node->left->key) {
-            node->left = leftRotate(node->left);
-            return rightRotate(node);
+            if (node->balance == 0) {
+                break;   // Nizsza strona wyrownana, wysokosc bez zmian
+            }
+            if (node->balance == 2 || node->balance == -2) {
+                // Po rotacji poddrzewo ma wysokosc sprzed wstawienia
+                *path[i] = rebalance(node);
+                break;
+            }
+            child = node;
         }
+    }
 
-        // Przypadek Prawy-Lewy
-        if (balance < -1 && key < node->right->key) {
-            node->right = rightRotate(node->right);
-            return leftRotate(node);
+    // Wstawianie wezla do drzewa AVL
+    // overwrite - czy nadpisac wartosc istniejacego klucza. Zwraca true, jesli dodano wezel.
+    template <typename... Args>
+    bool insertNode(const K& key, bool overwrite, Args&&... args) {
+        Node** path[MAX_HEIGHT];
+        int depth;
+        Node** link = findLink(key, path, depth);
+
+        if (*link != nullptr) {
+            // Klucz juz istnieje, aktualizacja wartosci
+            if (overwrite) {
+                (*link)->value = V(std::forward<Args>(args)...);
+            }
+            return false;
         }
 
-        return node;
+        *link = newNode(key, std::forward<Args>(args)...);
+        size++;
+        retraceInsert(path, depth, *link);
+        return true;
     }
 
-    // Znalezienie wezla z minimalna wartoscia
-    Node* minValueNode(Node* node) {
-        Node* current = node;
+    // Dolaczenie gotowego wezla; wezel z kluczem juz obecnym w drzewie jest zwalniany
+    void attachNode(Node* node) {
+        Node** path[MAX_HEIGHT];
+        int depth;
+        Node** link = findLink(node->key, path, depth);
 
-        while (current->left != nullptr) {
-            current = current->left;
+        if (*link != nullptr) {
+            freeNode(node);
+            return;
         }
 
-        return current;
+        node->left = nullptr;
+        node->right = nullptr;
+        node->balance = 0;
+        *link = node;
+        size++;
+        retraceInsert(path, depth, node);
     }
 
-    // Usuniecie wezla z drzewa AVL
-    Node* deleteNode(Node* root, int key, bool& deleted) {
-        // Wykonanie standardowego usuwania BST
-        if (root == nullptr) {
-            return root;
-        }
+    // Dopisanie wezla na poczatek budowanego ciagu (lista przez right, od
+    // najwiekszego klucza - dopisywane sa rosnaco)
+    void pushNode(Node* node) {
+        node->left = nullptr;
+        node->right = root;
+        root = node;
+        size++;
+    }
 
-        if (key < root->key) {
-            root->left = deleteNode(root->left, key, deleted);
-        }
-        else if (key > root->key) {
-            root->right = deleteNode(root->right, key, deleted);
+    // Zbudowanie idealnie zbalansowanego poddrzewa z count kolejnych wezlow
+    // listy (malejaco przez right); height - wysokosc wyniku. Glebokosc
+    // rekurencji to wysokosc budowanego drzewa.
+    static Node* buildBalanced(Node*& list, int count, int& height) {
+        if (count == 0) {
+            height = 0;
+            return nullptr;
         }
-        else {
-            // Wezel z kluczem do usuniecia
 
-            // Wezel z jednym dzieckiem lub bez dzieci
-            if (root->left == nullptr || root->right == nullptr) {
-                Node* temp = root->left ? root->left : root->right;
+        // Najpierw wieksze klucze, czyli prawe poddrzewo
+        int rightHeight;
+        int leftHeight;
+        Node* right = buildBalanced(list, count / 2, rightHeight);
+        Node* node = list;
+        list = list->right;
+        Node* left = buildBalanced(list, count - 1 - count / 2, leftHeight);
+
+        node->left = left;
+        node->right = right;
+        node->balance = (int8_t)(leftHeight - rightHeight);
+        height = 1 + max(leftHeight, rightHeight);
+        return node;
+    }
 
-                // Przypadek braku dzieci
-                if (temp == nullptr) {
-                    temp = root;
-                    root = nullptr;
-                }
-                else {
-                    // Przypadek jednego dziecka
-                    *root = *temp;
-                }
+    // Usuniecie wezla z drzewa AVL. Zwraca true, jesli klucz byl w drzewie.
+    bool deleteNode(const K& key) {
+        Node** path[MAX_HEIGHT];
+        bool wentLeft[MAX_HEIGHT];   // po ktorej stronie wezla path[i] lezy usuwany wezel
+        int depth = 0;
+
+        Node** link = &root;
+        while (true) {
+            Node* node = *link;
+            if (node == nullptr) {
+                return false;
+            }
 
-                delete temp;
-                size--;
-                deleted = true;
+            if (compare(key, node->key)) {
+                path[depth] = link;
+                wentLeft[depth++] = true;
+                link = &node->left;
+            }
+            else if (compare(node->key, key)) {
+                path[depth] = link;
+                wentLeft[depth++] = false;
+                link = &node->right;
             }
             else {
-                // Wezel z dwojgiem dzieci
-                Node* temp = minValueNode(root->right);
+                break;
+            }
+        }
 
-                // Kopiowanie danych nastepnika w porzadku inorder do tego wezla
-                root->key = temp->key;
-                root->value = temp->value;
+        Node* target = *link;
 
-                // Usuniecie nastepnika w porzadku inorder
-                root->right = deleteNode(root->right, temp->key, deleted);
+        // Wezel z dwojgiem dzieci: dane nastepnika w porzadku inorder trafiaja
+        // do tego wezla, a usuwany jest nastepnik (ma co najwyzej prawe dziecko)
+        if (target->left != nullptr && target->right != nullptr) {
+            path[depth] = link;
+            wentLeft[depth++] = false;
+            link = &target->right;
+
+            while ((*link)->left != nullptr) {
+                path[depth] = link;
+                wentLeft[depth++] = true;
+                link = &(*link)->left;
             }
-        }
 
-        // Jesli drzewo mialo tylko jeden wezel
-        if (root == nullptr) {
-            return root;
+            Node* successor = *link;
+            target->key = std::move(successor->key);
+            target->value = std::move(successor->value);
+            target = successor;
         }
 
-        // Aktualizacja wysokosci biezacego wezla
-        root->height = 1 + max(height(root->left), height(root->right));
+        // Wezel z jednym dzieckiem lub bez dzieci
+        *link = target->left != nullptr ? target->left : target->right;
+        freeNode(target);
+        size--;
 
-        // Pobranie wspolczynnika zbalansowania
-        int balance = getBalance(root);
+        // Powrot w gore sciezki, dopoki wysokosc poddrzewa maleje
+        for (int i = depth - 1; i >= 0; i--) {
+            Node* node = *path[i];
+            node->balance += wentLeft[i] ? -1 : 1;
 
-        // Lewa lewa
-        if (balance > 1 && getBalance(root->left) >= 0) {
-            return rightRotate(root);
+            if (node->balance == 1 || node->balance == -1) {
+                break;   // Wczesniej rowne strony, wysokosc bez zmian
+            }
+            if (node->balance == 2 || node->balance == -2) {
+                node = rebalance(node);
+                *path[i] = node;
+                // Rotacja wokol dziecka o wspolczynniku 0 nie zmniejsza wysokosci
+                if (node->balance != 0) {
+                    break;
+                }
+            }
         }
+        return true;
+    }
 
-        // Lewa prawa
-        if (balance > 1 && getBalance(root->left) < 0) {
-            root->left = leftRotate(root->left);
-            return rightRotate(root);
+    // Wyszukiwanie klucza w drzewie AVL
+    Node* search(const K& key) const {
+        Node* node = root;
+        while (node != nullptr) {
+            if (compare(node->key, key)) {
+                node = node->right;
+            }
+            else if (compare(key, node->key)) {
+                node = node->left;
+            }
+            else {
+                return node;
+            }
         }
+        return nullptr;
+    }
 
-        // Prawa prawa
-        if (balance < -1 && getBalance(root->right) <= 0) {
-            return leftRotate(root);
+    // Rozebranie drzewa w porzadku inorder bez stosu: lewe dziecko jest
+    // rotowane nad rodzica, az wezel nie ma lewego dziecka - wtedy jest
+    // najmniejszy. visit przejmuje kazdy wezel (zwalnia go albo przenosi).
+    template <typename Visit>
+    void dismantle(Visit visit) {
+        Node* node = root;
+        while (node != nullptr) {
+            if (node->left != nullptr) {
+                Node* left = node->left;
+                node->left = left->right;
+                left->right = node;
+                node = left;
+            }
+            else {
+                Node* right = node->right;
+                visit(node);
+                node = right;
+            }
         }
+        root = nullptr;
+        size = 0;
+    }
 
-        // Prawa lewa
-        if (balance < -1 && getBalance(root->right) > 0) {
-            root->right = rightRotate(root->right);
-            return leftRotate(root);
-        }
+public:
+    AVLTree() : root(nullptr), size(0), pool(nullptr) {}
 
-        return root;
+    // Ustawienie puli wezlow (tylko dla pustego drzewa)
+    void setPool(Pool* nodePool) {
+        pool = nodePool;
     }
 
-    // Wyszukiwanie klucza w drzewie AVL
-    Node* search(Node* root, int key) {
-        if (root == nullptr || root->key == key) {
-            return root;
+    // Odwiedzenie wszystkich par w porzadku kluczy: visit(key, value)
+    template <typename Visit>
+    void forEach(Visit visit) const {
+        Node* stack[MAX_HEIGHT];
+        int depth = 0;
+        Node* node = root;
+
+        while (node != nullptr || depth > 0) {
+            while (node != nullptr) {
+                stack[depth++] = node;
+                node = node->left;
+            }
+            node = stack[--depth];
+            visit(static_cast<const K&>(node->key), static_cast<const V&>(node->value));
+            node = node->right;
         }
+    }
 
-        if (root->key < key) {
-            return search(root->right, key);
-        }
+    // Przekazanie wszystkich par w porzadku kluczy: visit(K&& key, V&& value);
+    // wezly sa zwalniane po drodze, drzewo zostaje puste
+    template <typename Visit>
+    void drain(Visit visit) {
+        dismantle([&](Node* node) {
+            visit(std::move(node->key), std::move(node->value));
+            freeNode(node);
+        });
+    }
 
-        return search(root->left, key);
+    // Budowa drzewa z ciagu posortowanego w czasie O(n): na pustym drzewie
+    // kolejne pushSorted() z rosnacymi kluczami (albo distribute() innych
+    // drzew), a na koniec finishSorted(). Do tego czasu drzewo nie nadaje
+    // sie do innych operacji.
+    template <typename... Args>
+    void pushSorted(const K& key, Args&&... args) {
+        pushNode(newNode(key, std::forward<Args>(args)...));
     }
 
-    // Czyszczenie drzewa AVL
-    void clearTree(Node* node) {
-        if (node == nullptr) {
-            return;
+    // Zamiana ciagu z pushSorted() w drzewo idealnie zbalansowane. Ciag,
+    // ktory nie okazal sie rosnacy (np. zebrany z kilku drzew), jest
+    // wstawiany wezel po wezle.
+    void finishSorted() {
+        Node* list = root;
+        bool sorted = true;
+        for (Node* node = list; node != nullptr && node->right != nullptr; node = node->right) {
+            if (!compare(node->right->key, node->key)) {
+                sorted = false;
+                break;
+            }
         }
 
-        clearTree(node->left);
-        clearTree(node->right);
-        delete node;
-    }
-     
-    // Funkcja pomocnicza do pobierania wszystkich par
-    void getAllPairsHelper(Node* node, vector<pair<int, int>>& pairs) {
-        if (node == nullptr) {
+        root = nullptr;
+        if (sorted) {
+            int height;
+            root = buildBalanced(list, size, height);
             return;
         }
 
-        getAllPairsHelper(node->left, pairs);
-        pairs.push_back(make_pair(node->key, node->value));
-        getAllPairsHelper(node->right, pairs);
+        size = 0;
+        while (list != nullptr) {
+            Node* next = list->right;
+            attachNode(list);
+            list = next;
+        }
     }
 
-public:
-    AVLTree() : root(nullptr), size(0) {}
-
+    // Rozdzielenie wezlow miedzy drzewa target(key) bez kopiowania par;
+    // drzewo zostaje puste. Wezly trafiaja do drzew docelowych rosnaco
+    // jak przez pushSorted(), wiec kazde trzeba potem zamknac finishSorted().
+    // Drzewa docelowe musza korzystac z tej samej puli wezlow.
+    template <typename Target>
+    void distribute(Target target) {
+        dismantle([&](Node* node) {
+            AVLTree& destination = target(static_cast<const K&>(node->key));
+            destination.pushNode(node);
+        });
+    }
 
     // Pobranie wszystkich par klucz-wartosc z drzewa
-    void getAllPairs(vector<pair<int, int>>& pairs) {
-        getAllPairsHelper(root, pairs);
+    void getAllPairs(vector<pair<K, V>>& pairs) const {
+        forEach([&](const K& key, const V& value) {
+            pairs.push_back(make_pair(key, value));
+        });
     }
 
+    // Przeniesienie wszystkich par klucz-wartosc z drzewa; drzewo zostaje puste
+    void takeAllPairs(vector<pair<K, V>>& pairs) {
+        drain([&](K&& key, V&& value) {
+            pairs.push_back(make_pair(std::move(key), std::move(value)));
+        });
+    }
+
+    // Wezly z puli zwalnia jej wlasciciel, wszystkie naraz - chyba ze
+    // wymagaja wywolania destruktora
     ~AVLTree() {
-        clearTree(root);
+        if (pool == nullptr || !is_trivially_destructible<Node>::value) {
+            clear();
+        }
     }
 
-    // Wstawianie pary klucz-wartosc
-    void insert(int key, int value) {
-        root = insertNode(root, key, value);
+    // Wstawianie pary klucz-wartosc (istniejaca wartosc jest nadpisywana)
+    // Zwraca true, jesli klucz zostal dodany.
+    bool insert(const K& key, V value) {
+        return insertNode(key, true, std::move(value));
+    }
+
+    // Wstawienie wartosci zbudowanej w miejscu z args, jesli klucza nie ma
+    // w drzewie. Zwraca true, jesli klucz zostal dodany.
+    template <typename... Args>
+    bool emplace(const K& key, Args&&... args) {
+        return insertNode(key, false, std::forward<Args>(args)...);
     }
 
     // Usuwanie pary klucz-wartosc
-    bool remove(int key) {
-        bool deleted = false;
-        root = deleteNode(root, key, deleted);
-        return deleted;
+    bool remove(const K& key) {
+        return deleteNode(key);
     }
 
-    // Pobieranie wartosci dla klucza
-    int get(int key) {
-        Node* node = search(root, key);
+    // Wskaznik na wartosc dla klucza (nullptr gdy brak)
+    V* find(const K& key) {
+        Node* node = search(key);
         if (node == nullptr) {
-            return -1;
+            return nullptr;
         }
-        return node->value;
+        return &node->value;
+    }
+
+    const V* find(const K& key) const {
+        Node* node = search(key);
+        if (node == nullptr) {
+            return nullptr;
+        }
+        return &node->value;
     }
 
     // Czyszczenie drzewa AVL
     void clear() {
-        clearTree(root);
-        root = nullptr;
-        size = 0;
+        dismantle([&](Node* node) {
+            freeNode(node);
+        });
+    }
+
+    // Zlecenie pobrania korzenia (operacje wsadowe tablicy)
+    void prefetchRoot() const {
+        if (root != nullptr) {
+            prefetchRead(root);
+        }
     }
 
     // Pobieranie aktualnego rozmiaru
-    int getSize() {
+    int getSize() const {
         return size;
     }
+
+    // Wysokosc drzewa (0 - puste); sciezka zawsze w strone wyzszego poddrzewa
+    int getHeight() const {
+        int height = 0;
+        for (Node* node = root; node != nullptr; node = node->balance < 0 ? node->right : node->left) {
+            height++;
+        }
+        return height;
+    }
 };
 
 #endif
@@ -0,0 +1,813 @@
+#include <iostream>
+#include <cstdlib>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <optional>
+#include <type_traits>
+#include "open_addressing.hpp"
+#include "chaining.hpp"
+#include "avl.hpp"
+#include "hybrid.hpp"
+#include "sorted_bucket.hpp"
+#include "compact_avl_tree.hpp"
+#include "swiss_table.hpp"
+#include "robin_hood.hpp"
+#include "open_addressing_soa.hpp"
+#include "cuckoo_table.hpp"
+#include "concurrent_chaining.hpp"
+#include "lock_free_open_addressing.hpp"
+#include "concurrent_avl.hpp"
+#include "workload.hpp"
+
+// Nieinteraktywny program pomiarowy. Tablice, rozmiary, operacje i liczba
+// powtorzen sa podawane w parametrach wywolania (--help), wyniki trafiaja
+// na ekran oraz do plikow CSV i JSON.
+// Operacje sa mierzone porcjami po --batch operacji: jeden pomiar zegara
+// przypada na cala porcje, wiec narzut zegara nie dominuje wyniku. Kazda
+// porcja daje jedna probke (ns na operacje); dla probek liczone sa min,
+// mediana, p90, p99, srednia i odchylenie standardowe.
+
+using namespace std;
+
+// Ustawienia pomiaru z parametrow wywolania
+struct Config {
+    vector<string> tables;
+    vector<int> sizes;
+    vector<string> operations;
+    int reps;
+    int warmup;
+    int batch;
+    KeyPattern keys;      // wzorzec kluczy wstawianych tablic
+    string mix;           // mieszanka operacji mixed (workload.hpp)
+    double zipfTheta;
+    unsigned int seed;
+    string csvPath;
+    string jsonPath;
+    string statsCsvPath;
+    bool quiet;
+    bool stats;           // zbieranie statystyk struktury (getStats)
+
+    Config() : reps(5), warmup(1), batch(1000), keys(KeyPattern::UNIFORM), mix("b"), zipfTheta(0.99), seed(12345), quiet(false), stats(false) {
+        tables = { "oa", "chaining", "avl" };
+        sizes = { 10000, 100000, 1000000 };
+        operations = { "insert", "find", "remove" };
+    }
+};
+
+// Wynik jednej operacji dla jednej tablicy i jednego rozmiaru (ns na operacje)
+struct Result {
+    string table;
+    int size;
+    string keys;
+    string operation;
+    int samples;
+    double mean;
+    double min;
+    double median;
+    double p90;
+    double p99;
+    double max;
+    double stddev;
+};
+
+// Wyniki wyszukiwan zapisywane tutaj, aby optymalizator ich nie usunal
+volatile long long resultSink = 0;
+
+// Operacje w kolejnosci wykonywania na jednej tablicy:
+// insert - wstawienie wszystkich kluczy (tablica jest wypelniana zawsze),
+// find - wyszukanie kluczy obecnych, miss - kluczy nieobecnych,
+// mixed - mieszanka operacji (--mix), churn-find i churn-miss - wyszukiwania
+// po wymianie tylu kluczy, ile jest w tablicy (usuniecie losowego i wstawienie
+// nowego), remove - usuniecie obecnych kluczy
+const char* const OPERATIONS[] = { "insert", "find", "miss", "mixed", "churn-find", "churn-miss", "remove" };
+
+enum OperationIndex { OP_INSERT, OP_FIND, OP_MISS, OP_MIXED, OP_CHURN_FIND, OP_CHURN_MISS, OP_REMOVE, NUM_OPERATIONS };
+
+// Dane jednego powtorzenia: klucze i wartosci wstawiane do tablicy,
+// strumien operacji mixed oraz klucze wyszukiwan chybionych i wymiany.
+// Klucze wzorcow sa dodatnie, wiec klucze nieobecne i wstawiane przy
+// wymianie sa ujemne (z rozlacznych przedzialow).
+struct Workload {
+    Dataset data;
+    vector<Operation> operations;
+    vector<int> missingKeys;
+    vector<int> churnKeys;       // nowe klucze wymiany, rozne
+    vector<int> churnSlots;      // indeksy wymienianych kluczy
+};
+
+// Najmniejszy klucz wstawiany przy wymianie; klucze nieobecne sa mniejsze
+const int CHURN_KEY_MIN = -(1 << 30);
+
+// Percentyl p (0-100) z posortowanego wektora probek
+double percentile(const vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t index = (size_t)(p / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[index];
+}
+
+// Podsumowanie probek jednej operacji
+Result summarize(const string& table, int size, KeyPattern keys, const string& operation, vector<double> samples) {
+    Result result;
+    result.table = table;
+    result.size = size;
+    result.keys = keyPatternName(keys);
+    result.operation = operation;
+    result.samples = (int)samples.size();
+
+    sort(samples.begin(), samples.end());
+
+    double sum = 0;
+    for (size_t i = 0; i < samples.size(); i++) {
+        sum += samples[i];
+    }
+    result.mean = samples.empty() ? 0 : sum / samples.size();
+
+    // Odchylenie standardowe z proby
+    double squares = 0;
+    for (size_t i = 0; i < samples.size(); i++) {
+        squares += (samples[i] - result.mean) * (samples[i] - result.mean);
+    }
+    result.stddev = samples.size() > 1 ? sqrt(squares / (samples.size() - 1)) : 0;
+
+    result.min = samples.empty() ? 0 : samples.front();
+    result.max = samples.empty() ? 0 : samples.back();
+    result.median = percentile(samples, 50);
+    result.p90 = percentile(samples, 90);
+    result.p99 = percentile(samples, 99);
+    return result;
+}
+
+// Statystyki struktury tablicy w chwili phase ostatniego mierzonego powtorzenia
+struct StatsEntry {
+    string table;
+    int size;
+    string keys;
+    string phase;
+    TableStats stats;
+};
+
+// Wszystkie wyniki pomiaru
+struct Report {
+    vector<Result> results;
+    vector<StatsEntry> stats;
+};
+
+// Czy tablica udostepnia getStats() (table_stats.hpp)
+template <typename Table, typename = void>
+struct HasStats : false_type {};
+
+template <typename Table>
+struct HasStats<Table, void_t<decltype(declval<const Table&>().getStats())>> : true_type {};
+
+// Zapis statystyk tablicy, jesli je udostepnia i sa zbierane
+template <typename Table>
+void recordStats(const Config& config, const Table& table, const string& name, int size, const char* phase, Report& report) {
+    if constexpr (HasStats<Table>::value) {
+        if (config.stats) {
+            StatsEntry entry;
+            entry.table = name;
+            entry.size = size;
+            entry.keys = keyPatternName(config.keys);
+            entry.phase = phase;
+            entry.stats = table.getStats();
+            report.stats.push_back(entry);
+        }
+    }
+}
+
+// Odczyt wartosci - tablice szablonowe zwracaja optional, pozostale -1 gdy brak
+template <typename Table>
+long long lookup(Table& table, int key) {
+    auto value = table.get(key);
+    if constexpr (is_same<decltype(value), optional<int>>::value) {
+        return value.has_value() ? *value : -1;
+    }
+    else {
+        return value;
+    }
+}
+
+// Czy tablica ma tryb przyrostowej zmiany rozmiaru (Table::incremental())
+template <typename Table, typename = void>
+struct HasIncremental : false_type {};
+
+template <typename Table>
+struct HasIncremental<Table, void_t<decltype(Table::incremental())>> : true_type {};
+
+// Nowa tablica; incremental - tryb przyrostowej zmiany rozmiaru (jesli jest)
+template <typename Table>
+Table* createTable(bool incremental) {
+    if constexpr (HasIncremental<Table>::value) {
+        if (incremental) {
+            return new Table(Table::incremental());
+        }
+    }
+    return new Table();
+}
+
+// Wykonanie op(i) dla i z [0, count) porcjami po batch, z pomiarem czasu
+// kazdej porcji. record - czy zapisywac probki (rozgrzewka ich nie zapisuje).
+template <typename Operation>
+void timeBatches(int count, int batch, bool record, vector<double>& samples, Operation op) {
+    for (int start = 0; start < count; start += batch) {
+        int end = min(start + batch, count);
+
+        auto begin = chrono::steady_clock::now();
+        for (int i = start; i < end; i++) {
+            op(i);
+        }
+        auto finish = chrono::steady_clock::now();
+
+        if (record) {
+            double ns = (double)chrono::duration_cast<chrono::nanoseconds>(finish - begin).count();
+            samples.push_back(ns / (end - start));
+        }
+    }
+}
+
+bool hasOperation(const Config& config, const string& operation) {
+    return find(config.operations.begin(), config.operations.end(), operation) != config.operations.end();
+}
+
+// Wszystkie powtorzenia pomiaru jednej tablicy dla jednego rozmiaru.
+// workloads[r] - dane powtorzenia r (najpierw rozgrzewkowe), te same dla
+// wszystkich tablic.
+template <typename Table>
+void runTable(const Config& config, const string& name, bool incremental, const vector<Workload>& workloads,
+    Report& report) {
+    bool enabled[NUM_OPERATIONS];
+    for (int o = 0; o < NUM_OPERATIONS; o++) {
+        enabled[o] = hasOperation(config, OPERATIONS[o]);
+    }
+
+    vector<vector<double>> samples(NUM_OPERATIONS);
+    long long checksum = 0;
+    int size = 0;
+
+    for (int r = 0; r < (int)workloads.size(); r++) {
+        bool record = r >= config.warmup;
+        bool last = r + 1 == (int)workloads.size();
+        const Workload& workload = workloads[r];
+        const vector<int>& values = workload.data.values;
+        size = (int)workload.data.keys.size();
+
+        // Klucze obecne w tablicy - zmieniaja sie przy wymianie
+        vector<int> keys = workload.data.keys;
+
+        Table* table = createTable<Table>(incremental);
+
+        // Wstawianie zawsze wypelnia tablice, mierzone tylko na zadanie
+        timeBatches(size, config.batch, record && enabled[OP_INSERT], samples[OP_INSERT],
+            [&](int i) { table->insert(keys[i], values[i]); });
+
+        if (last) {
+            recordStats(config, *table, name, size, "insert", report);
+        }
+
+        if (enabled[OP_FIND]) {
+            timeBatches(size, config.batch, record, samples[OP_FIND],
+                [&](int i) { checksum += lookup(*table, keys[i]); });
+        }
+
+        if (enabled[OP_MISS]) {
+            timeBatches(size, config.batch, record, samples[OP_MISS],
+                [&](int i) { checksum += lookup(*table, workload.missingKeys[i]); });
+        }
+
+        if (enabled[OP_MIXED]) {
+            timeBatches((int)workload.operations.size(), config.batch, record, samples[OP_MIXED], [&](int i) {
+                const Operation& op = workload.operations[i];
+                switch (op.type) {
+                case OperationType::READ:
+                    checksum += lookup(*table, op.key);
+                    break;
+                case OperationType::UPDATE:
+                case OperationType::INSERT:
+                    table->insert(op.key, op.value);
+                    break;
+                case OperationType::REMOVE:
+                    table->remove(op.key);
+                    break;
+                }
+            });
+        }
+
+        if (enabled[OP_CHURN_FIND] || enabled[OP_CHURN_MISS]) {
+            // Wymiana kluczy (niemierzona) - w adresowaniu otwartym zostaja nagrobki
+            for (int i = 0; i < size; i++) {
+                int slot = workload.churnSlots[i];
+                table->remove(keys[slot]);
+                keys[slot] = workload.churnKeys[i];
+                table->insert(keys[slot], values[slot]);
+            }
+
+            if (last) {
+                recordStats(config, *table, name, size, "churn", report);
+            }
+
+            if (enabled[OP_CHURN_FIND]) {
+                timeBatches(size, config.batch, record, samples[OP_CHURN_FIND],
+                    [&](int i) { checksum += lookup(*table, keys[i]); });
+            }
+            if (enabled[OP_CHURN_MISS]) {
+                timeBatches(size, config.batch, record, samples[OP_CHURN_MISS],
+                    [&](int i) { checksum += lookup(*table, workload.missingKeys[i]); });
+            }
+        }
+
+        if (enabled[OP_REMOVE]) {
+            timeBatches(size, config.batch, record, samples[OP_REMOVE],
+                [&](int i) { table->remove(keys[i]); });
+        }
+
+        delete table;
+    }
+
+    // Zapobiega usunieciu wyszukiwan przez optymalizator
+    resultSink = checksum;
+
+    for (int o = 0; o < NUM_OPERATIONS; o++) {
+        if (enabled[o]) {
+            report.results.push_back(summarize(name, size, config.keys, OPERATIONS[o], samples[o]));
+        }
+    }
+}
+
+// Tablica dostepna w parametrze --tables
+struct TableEntry {
+    const char* name;
+    const char* description;
+    void (*run)(const Config&, const string&, bool, const vector<Workload>&, Report&);
+    bool incremental;
+};
+
+const TableEntry TABLES[] = {
+    { "oa", "adresowanie otwarte", &runTable<HashTableOpenAddressing<>>, false },
+    { "oa-inc", "adresowanie otwarte, przyrostowa zmiana rozmiaru", &runTable<HashTableOpenAddressing<>>, true },
+    { "chaining", "lancuchowanie (listy)", &runTable<HashTableChaining<>>, false },
+    { "chaining-inc", "lancuchowanie, przyrostowa zmiana rozmiaru", &runTable<HashTableChaining<>>, true },
+    { "avl", "lancuchowanie (drzewa AVL)", &runTable<HashTableAVL<>>, false },
+    { "hybrid", "lancuchowanie, dlugie listy zamieniane w drzewa AVL", &runTable<HashTableHybrid<>>, false },
+    { "sorted-array", "lancuchowanie (posortowane tablice w liniach pamieci, B+-drzewo)",
+        &runTable<HashTableAVL<int, int, hash<int>, less<int>, FibonacciHash, SortedArrayBucket<>>>, false },
+    { "avl-compact", "lancuchowanie (drzewa AVL w arenie, indeksy 32-bitowe)",
+        &runTable<HashTableAVL<int, int, hash<int>, less<int>, FibonacciHash, CompactAVLTree<>>>, false },
+    { "swiss", "adresowanie otwarte Swiss (SSE2)", &runTable<HashTableSwiss>, false },
+    { "robin", "adresowanie otwarte Robin Hood", &runTable<HashTableRobinHood>, false },
+    { "soa", "adresowanie otwarte, struktura tablic", &runTable<HashTableOpenAddressingSoA>, false },
+    { "cuckoo", "haszowanie kukulcze (kubelki 4-miejscowe, SSE2)", &runTable<HashTableCuckoo>, false },
+    { "concurrent-chaining", "wspolbiezne lancuchowanie (shardy)", &runTable<ConcurrentHashTableChaining<>>, false },
+    { "lock-free", "adresowanie otwarte bez blokad", &runTable<LockFreeHashTableOpenAddressing<>>, false },
+    { "concurrent-avl", "drzewa AVL, odczyty bez blokad", &runTable<ConcurrentHashTableAVL<>>, false },
+};
+const int NUM_TABLES = sizeof(TABLES) / sizeof(TABLES[0]);
+
+const TableEntry* findTable(const string& name) {
+    for (int i = 0; i < NUM_TABLES; i++) {
+        if (name == TABLES[i].name) {
+            return &TABLES[i];
+        }
+    }
+    return nullptr;
+}
+
+void printUsage(ostream& out) {
+    out << "Uzycie: benchmark [opcje]\n"
+        << "  --tables=a,b,...    tablice (domyslnie oa,chaining,avl; all - wszystkie)\n"
+        << "  --sizes=n,m,...     liczby elementow (domyslnie 10000,100000,1000000)\n"
+        << "  --ops=a,b,...       operacje: insert, find, miss, mixed, churn-find, churn-miss, remove\n"
+        << "                      (domyslnie insert,find,remove)\n"
+        << "  --keys=wzorzec      klucze: uniform, sequential, strided, clustered, zipf, flood (domyslnie uniform)\n"
+        << "  --mix=nazwa         mieszanka operacji mixed: a, b, c, d (YCSB), churn (domyslnie b)\n"
+        << "  --zipf=theta        parametr rozkladu Zipfa z (0, 1) (domyslnie 0.99)\n"
+        << "  --reps=n            mierzone powtorzenia (domyslnie 5)\n"
+        << "  --warmup=n          powtorzenia rozgrzewkowe, niemierzone (domyslnie 1)\n"
+        << "  --batch=n           operacje na jeden pomiar czasu (domyslnie 1000)\n"
+        << "  --seed=n            ziarno generatora danych (domyslnie 12345)\n"
+        << "  --csv=plik          zapis wynikow CSV\n"
+        << "  --json=plik         zapis wynikow JSON\n"
+        << "  --stats             statystyki struktury (oa, chaining, avl, hybrid, sorted-array, avl-compact, cuckoo) po wstawieniu i po wymianie;\n"
+        << "                      liczniki zmian rozmiaru wymagaja kompilacji z -DHASH_TABLE_STATS\n"
+        << "  --stats-csv=plik    zapis statystyk struktury CSV (wlacza --stats)\n"
+        << "  --quiet             bez wynikow na ekranie\n"
+        << "  --help              ta pomoc\n"
+        << "Tablice:\n";
+    for (int i = 0; i < NUM_TABLES; i++) {
+        out << "  " << TABLES[i].name << " - " << TABLES[i].description << "\n";
+    }
+}
+
+// Podzial listy oddzielonej przecinkami
+vector<string> splitList(const string& text) {
+    vector<string> items;
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t comma = text.find(',', start);
+        if (comma == string::npos) {
+            comma = text.size();
+        }
+        if (comma > start) {
+            items.push_back(text.substr(start, comma - start));
+        }
+        start = comma + 1;
+    }
+    return items;
+}
+
+// Liczba calkowita z parametru; false gdy tekst nie jest liczba z [minValue, maxValue]
+bool parseInt(const string& text, long long minValue, long long maxValue, long long& value) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    value = strtoll(text.c_str(), &end, 10);
+    return *end == '\0' && value >= minValue && value <= maxValue;
+}
+
+// Odczyt parametrow wywolania. Zwraca false (po wypisaniu bledu) gdy sa niepoprawne.
+bool parseArguments(int argc, char** argv, Config& config, bool& help) {
+    help = false;
+
+    for (int i = 1; i < argc; i++) {
+        string argument = argv[i];
+        if (argument == "--help" || argument == "-h") {
+            help = true;
+            return true;
+        }
+        if (argument == "--quiet") {
+            config.quiet = true;
+            continue;
+        }
+        if (argument == "--stats") {
+            config.stats = true;
+            continue;
+        }
+
+        // --nazwa=wartosc albo --nazwa wartosc
+        size_t equals = argument.find('=');
+        string name = argument.substr(0, equals);
+        string value;
+        if (equals != string::npos) {
+            value = argument.substr(equals + 1);
+        }
+        else if (i + 1 < argc) {
+            value = argv[++i];
+        }
+        else {
+            cerr << "Brak wartosci parametru " << name << endl;
+            return false;
+        }
+
+        long long number = 0;
+        if (name == "--tables") {
+            config.tables = splitList(value);
+            if (config.tables.size() == 1 && config.tables[0] == "all") {
+                config.tables.clear();
+                for (int t = 0; t < NUM_TABLES; t++) {
+                    config.tables.push_back(TABLES[t].name);
+                }
+            }
+            for (size_t t = 0; t < config.tables.size(); t++) {
+                if (findTable(config.tables[t]) == nullptr) {
+                    cerr << "Nieznana tablica: " << config.tables[t] << endl;
+                    return false;
+                }
+            }
+        }
+        else if (name == "--sizes") {
+            vector<string> items = splitList(value);
+            config.sizes.clear();
+            for (size_t s = 0; s < items.size(); s++) {
+                if (!parseInt(items[s], 1, 200000000, number)) {
+                    cerr << "Niepoprawny rozmiar: " << items[s] << endl;
+                    return false;
+                }
+                config.sizes.push_back((int)number);
+            }
+        }
+        else if (name == "--ops") {
+            config.operations = splitList(value);
+            for (size_t o = 0; o < config.operations.size(); o++) {
+                const char* const* last = OPERATIONS + NUM_OPERATIONS;
+                if (find(OPERATIONS, last, config.operations[o]) == last) {
+                    cerr << "Nieznana operacja: " << config.operations[o] << endl;
+                    return false;
+                }
+            }
+        }
+        else if (name == "--keys") {
+            if (!parseKeyPattern(value, config.keys)) {
+                cerr << "Nieznany wzorzec kluczy: " << value << endl;
+                return false;
+            }
+        }
+        else if (name == "--mix") {
+            if (findOperationMix(value) == nullptr) {
+                cerr << "Nieznana mieszanka operacji: " << value << endl;
+                return false;
+            }
+            config.mix = value;
+        }
+        else if (name == "--zipf") {
+            char* end = nullptr;
+            config.zipfTheta = strtod(value.c_str(), &end);
+            if (value.empty() || *end != '\0' || !(config.zipfTheta > 0 && config.zipfTheta < 1)) {
+                cerr << "Niepoprawny parametr Zipfa: " << value << endl;
+                return false;
+            }
+        }
+        else if (name == "--reps" && parseInt(value, 1, 1000000, number)) {
+            config.reps = (int)number;
+        }
+        else if (name == "--warmup" && parseInt(value, 0, 1000000, number)) {
+            config.warmup = (int)number;
+        }
+        else if (name == "--batch" && parseInt(value, 1, 100000000, number)) {
+            config.batch = (int)number;
+        }
+        else if (name == "--seed" && parseInt(value, 0, 4294967295LL, number)) {
+            config.seed = (unsigned int)number;
+        }
+        else if (name == "--csv") {
+            config.csvPath = value;
+        }
+        else if (name == "--json") {
+            config.jsonPath = value;
+        }
+        else if (name == "--stats-csv") {
+            config.statsCsvPath = value;
+            config.stats = true;
+        }
+        else {
+            cerr << "Niepoprawny parametr: " << argument << endl;
+            return false;
+        }
+    }
+
+    if (config.tables.empty() || config.sizes.empty() || config.operations.empty()) {
+        cerr << "Pusta lista tablic, rozmiarow albo operacji" << endl;
+        return false;
+    }
+    return true;
+}
+
+// Tekst w cudzyslowie dla JSON
+string jsonString(const string& text) {
+    string quoted = "\"";
+    for (size_t i = 0; i < text.size(); i++) {
+        char c = text[i];
+        if (c == '"' || c == '\\') {
+            quoted += '\\';
+            quoted += c;
+        }
+        else if ((unsigned char)c < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            quoted += escaped;
+        }
+        else {
+            quoted += c;
+        }
+    }
+    return quoted + "\"";
+}
+
+// Lista tekstow jako tablica JSON
+string jsonList(const vector<string>& items) {
+    string list = "[";
+    for (size_t i = 0; i < items.size(); i++) {
+        list += (i > 0 ? ", " : "") + jsonString(items[i]);
+    }
+    return list + "]";
+}
+
+bool writeCsv(const string& path, const vector<Result>& results) {
+    ofstream outFile(path);
+    if (!outFile) {
+        cerr << "Nie mozna zapisac pliku " << path << endl;
+        return false;
+    }
+
+    outFile << "table,size,keys,operation,samples,mean_ns,min_ns,median_ns,p90_ns,p99_ns,max_ns,stddev_ns\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        outFile << r.table << "," << r.size << "," << r.keys << "," << r.operation << "," << r.samples << ","
+            << r.mean << "," << r.min << "," << r.median << "," << r.p90 << ","
+            << r.p99 << "," << r.max << "," << r.stddev << "\n";
+    }
+    return true;
+}
+
+// Statystyki struktury CSV: podsumowania rozkladow, bez pelnych histogramow
+bool writeStatsCsv(const string& path, const vector<StatsEntry>& entries) {
+    ofstream outFile(path);
+    if (!outFile) {
+        cerr << "Nie mozna zapisac pliku " << path << endl;
+        return false;
+    }
+
+    outFile << "table,size,keys,phase,elements,capacity,tombstones,probe_mean,probe_p99,probe_max,"
+        << "chain_mean,chain_p99,chain_max,height_mean,height_max,tree_size_max,node_bytes,resizes,rehash_ns\n";
+    for (size_t i = 0; i < entries.size(); i++) {
+        const StatsEntry& e = entries[i];
+        const TableStats& st = e.stats;
+        outFile << e.table << "," << e.size << "," << e.keys << "," << e.phase << ","
+            << st.size << "," << st.capacity << "," << st.tombstones << ","
+            << st.probeLengths.mean() << "," << st.probeLengths.percentile(99) << "," << st.probeLengths.max() << ","
+            << st.chainLengths.mean() << "," << st.chainLengths.percentile(99) << "," << st.chainLengths.max() << ","
+            << st.treeHeights.mean() << "," << st.treeHeights.max() << "," << st.treeSizes.max() << ","
+            << st.nodeBytes << ",";
+        if (st.countersEnabled) {
+            outFile << st.resizes << "," << st.rehashNanoseconds;
+        }
+        else {
+            outFile << ",";
+        }
+        outFile << "\n";
+    }
+    return true;
+}
+
+// Histogram jako tablica JSON liczb wystapien kolejnych wartosci
+string jsonHistogram(const Histogram& histogram) {
+    string list = "[";
+    for (int v = 0; v < histogram.buckets(); v++) {
+        list += (v > 0 ? ", " : "") + to_string(histogram.count(v));
+    }
+    return list + "]";
+}
+
+bool writeJson(const string& path, const Config& config, const Report& report) {
+    const vector<Result>& results = report.results;
+    ofstream outFile(path);
+    if (!outFile) {
+        cerr << "Nie mozna zapisac pliku " << path << endl;
+        return false;
+    }
+
+    outFile << "{\n  \"config\": {\n"
+        << "    \"tables\": " << jsonList(config.tables) << ",\n"
+        << "    \"sizes\": [";
+    for (size_t s = 0; s < config.sizes.size(); s++) {
+        outFile << (s > 0 ? ", " : "") << config.sizes[s];
+    }
+    outFile << "],\n"
+        << "    \"operations\": " << jsonList(config.operations) << ",\n"
+        << "    \"keys\": " << jsonString(keyPatternName(config.keys)) << ",\n"
+        << "    \"mix\": " << jsonString(config.mix) << ",\n"
+        << "    \"zipf_theta\": " << config.zipfTheta << ",\n"
+        << "    \"reps\": " << config.reps << ",\n"
+        << "    \"warmup\": " << config.warmup << ",\n"
+        << "    \"batch\": " << config.batch << ",\n"
+        << "    \"seed\": " << config.seed << "\n"
+        << "  },\n  \"results\": [\n";
+
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        outFile << "    {\"table\": " << jsonString(r.table) << ", \"size\": " << r.size
+            << ", \"keys\": " << jsonString(r.keys) << ", \"operation\": " << jsonString(r.operation) << ", \"samples\": " << r.samples
+            << ", \"mean_ns\": " << r.mean << ", \"min_ns\": " << r.min
+            << ", \"median_ns\": " << r.median << ", \"p90_ns\": " << r.p90
+            << ", \"p99_ns\": " << r.p99 << ", \"max_ns\": " << r.max
+            << ", \"stddev_ns\": " << r.stddev << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    outFile << "  ]";
+
+    if (config.stats) {
+        outFile << ",\n  \"stats\": [\n";
+        for (size_t i = 0; i < report.stats.size(); i++) {
+            const StatsEntry& e = report.stats[i];
+            const TableStats& st = e.stats;
+            outFile << "    {\"table\": " << jsonString(e.table) << ", \"size\": " << e.size
+                << ", \"keys\": " << jsonString(e.keys) << ", \"phase\": " << jsonString(e.phase)
+                << ", \"elements\": " << st.size << ", \"capacity\": " << st.capacity
+                << ", \"tombstones\": " << st.tombstones
+                << ", \"probe_lengths\": " << jsonHistogram(st.probeLengths)
+                << ", \"chain_lengths\": " << jsonHistogram(st.chainLengths)
+                << ", \"tree_heights\": " << jsonHistogram(st.treeHeights)
+                << ", \"tree_sizes\": " << jsonHistogram(st.treeSizes)
+                << ", \"node_bytes\": " << st.nodeBytes;
+            if (st.countersEnabled) {
+                outFile << ", \"resizes\": " << st.resizes << ", \"rehash_ns\": " << st.rehashNanoseconds;
+            }
+            outFile << "}" << (i + 1 < report.stats.size() ? "," : "") << "\n";
+        }
+        outFile << "  ]";
+    }
+
+    outFile << "\n}\n";
+    return true;
+}
+
+void printStats(const StatsEntry& e) {
+    const TableStats& st = e.stats;
+    cout << "  " << e.table << " struktura (" << e.phase << "): " << st.size << " elementow, pojemnosc " << st.capacity;
+    if (!st.probeLengths.empty()) {
+        cout << ", sondowanie srednio " << st.probeLengths.mean() << " (p99 " << st.probeLengths.percentile(99)
+            << ", max " << st.probeLengths.max() << "), nagrobki " << st.tombstones;
+    }
+    if (!st.chainLengths.empty()) {
+        cout << ", lancuch srednio " << st.chainLengths.mean() << " (p99 " << st.chainLengths.percentile(99)
+            << ", max " << st.chainLengths.max() << ")";
+    }
+    if (!st.treeHeights.empty()) {
+        cout << ", wysokosc drzewa srednio " << st.treeHeights.mean() << " (max " << st.treeHeights.max()
+            << "), najwieksze drzewo " << st.treeSizes.max();
+    }
+    if (st.nodeBytes > 0 && st.size > 0) {
+        cout << ", wezly " << st.nodeBytes << " B (" << (double)st.nodeBytes / st.size << " B na element)";
+    }
+    if (st.countersEnabled) {
+        cout << ", zmiany rozmiaru " << st.resizes << " (" << st.rehashNanoseconds / 1e6 << " ms)";
+    }
+    cout << endl;
+}
+
+void printResult(const Result& r) {
+    cout << "  " << r.table << " " << r.operation << ": mediana " << r.median << " ns, min " << r.min
+        << ", p90 " << r.p90 << ", p99 " << r.p99 << ", srednia " << r.mean
+        << " +- " << r.stddev << " ns (" << r.samples << " probek)" << endl;
+}
+
+int main(int argc, char** argv) {
+    Config config;
+    bool help = false;
+    if (!parseArguments(argc, argv, config, help)) {
+        printUsage(cerr);
+        return 1;
+    }
+    if (help) {
+        printUsage(cout);
+        return 0;
+    }
+
+    Report report;
+    vector<Result>& results = report.results;
+    for (size_t s = 0; s < config.sizes.size(); s++) {
+        int size = config.sizes[s];
+        if (!config.quiet) {
+            cout << "Rozmiar: " << size << ", klucze: " << keyPatternName(config.keys) << endl;
+        }
+
+        // Zestawy danych generowane raz i podawane kolejno kazdej tablicy;
+        // powtorzenie r uzywa ziarna seed + r
+        const OperationMix* mix = findOperationMix(config.mix);
+        vector<Workload> workloads(config.warmup + config.reps);
+        for (int r = 0; r < (int)workloads.size(); r++) {
+            workloads[r].data = generateDataset(config.keys, size, config.seed + r, config.zipfTheta);
+            FastRandom random(config.seed + r + 0x9e3779b9u);
+            if (hasOperation(config, "mixed")) {
+                workloads[r].operations = generateOperations(*mix, workloads[r].data.keys, size, random, config.zipfTheta);
+            }
+            if (hasOperation(config, "miss") || hasOperation(config, "churn-miss")) {
+                workloads[r].missingKeys.resize(size);
+                for (int i = 0; i < size; i++) {
+                    workloads[r].missingKeys[i] = random.nextInt(INT_MIN + 2, CHURN_KEY_MIN - 1);
+                }
+            }
+            if (hasOperation(config, "churn-find") || hasOperation(config, "churn-miss")) {
+                workloads[r].churnKeys = uniqueKeys(size, CHURN_KEY_MIN, -1, random);
+                workloads[r].churnSlots.resize(size);
+                for (int i = 0; i < size; i++) {
+                    workloads[r].churnSlots[i] = (int)random.nextBelow(size);
+                }
+            }
+        }
+
+        for (size_t t = 0; t < config.tables.size(); t++) {
+            const TableEntry* entry = findTable(config.tables[t]);
+            size_t first = results.size();
+            size_t firstStats = report.stats.size();
+            entry->run(config, entry->name, entry->incremental, workloads, report);
+
+            if (!config.quiet) {
+                for (size_t i = first; i < results.size(); i++) {
+                    printResult(results[i]);
+                }
+                for (size_t i = firstStats; i < report.stats.size(); i++) {
+                    printStats(report.stats[i]);
+                }
+            }
+        }
+    }
+
+    bool written = true;
+    if (!config.csvPath.empty()) {
+        written = writeCsv(config.csvPath, results) && written;
+    }
+    if (!config.jsonPath.empty()) {
+        written = writeJson(config.jsonPath, config, report) && written;
+    }
+    if (!config.statsCsvPath.empty()) {
+        written = writeStatsCsv(config.statsCsvPath, report.stats) && written;
+    }
+
+    return written ? 0 : 1;
+}
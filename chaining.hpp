@@ -2,229 +2,805 @@
 #define CHAINING_HPP
 
 #include <iostream>
+#include <memory>
+#include <algorithm>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include "hash_policy.hpp"
+#include "node_pool.hpp"
+#include "cow_array.hpp"
+#include "prefetch.hpp"
+#include "table_stats.hpp"
 
 using namespace std;
 
 // Prosta tablica mieszajaca z lancuchowaniem (listy powiazane)
+// K, V - typy klucza i wartosci
+// Hash, KeyEqual - funkcja skrotu i porownanie kluczy
+// HashPolicy - polityka mieszania z hash_policy.hpp
+// W trybie przyrostowym zmiana rozmiaru nie przenosi wszystkich elementow
+// naraz - stara i nowa tablica istnieja obok siebie, a kazde wstawienie
+// i usuniecie przenosi kilka kubelkow starej tablicy.
+// Kubelki leza w CowArray, wiec snapshot() kosztuje O(1), a zapisy po migawce
+// kopiuja tylko segmenty kubelkow (razem z ich listami), ktore zmieniaja.
+// Tablica, z ktorej przeniesiono zawartosc, nie ma kubelkow ani puli
+// (pojemnosc 0) - dostaje je przy pierwszym wstawieniu.
+template <typename K = int, typename V = int, typename Hash = hash<K>,
+    typename KeyEqual = equal_to<K>, typename HashPolicy = FibonacciHash>
 class HashTableChaining {
 private:
     // Struktura wezla dla listy powiazanej
     struct Node {
-        int key;
-        int value;
+        K key;
+        V value;
         Node* next;
 
-        Node(int k, int v) : key(k), value(v), next(nullptr) {}
+        template <typename... Args>
+        Node(const K& k, Args&&... args) : key(k), value(std::forward<Args>(args)...), next(nullptr) {}
     };
 
-    Node** table;
+    typedef NodePool<Node> Pool;
+
+    // Operacje na kubelkach dla CowArray: kopia kubelka kopiuje jego liste,
+    // zwolnienie kubelka oddaje wezly listy do puli
+    struct BucketOps {
+        Pool* pool;
+
+        BucketOps() : pool(nullptr) {}
+        explicit BucketOps(Pool* nodePool) : pool(nodePool) {}
+
+        void copy(Node* const& from, Node*& to) {
+            to = copyList(*pool, from);
+        }
+
+        void destroy(Node*& head) {
+            destroyList(*pool, head);
+            head = nullptr;
+        }
+    };
+
+    typedef CowArray<Node*, BucketOps> Buckets;
+
+    shared_ptr<Pool> pool;               // wspolna dla tablicy i jej migawek
+    Buckets table;
     int capacity;
     int size;
     const double LOAD_FACTOR_THRESHOLD = 1.0;
+    Hash hasher;
+    KeyEqual keyEqual;
+    HashPolicy policy;
+
+    // Przyrostowa zmiana rozmiaru
+    static const int MIGRATE_STEP = 4;   // kubelki przenoszone przy jednej operacji
+    bool incrementalResize;
+    Buckets oldTable;                    // pusta gdy migracja nie trwa
+    int oldCapacity;
+    int migrateIndex;                    // pierwszy nieprzeniesiony kubelek starej tablicy
+    HashPolicy oldPolicy;
+
+#ifdef HASH_TABLE_STATS
+    ResizeCounters counters;
+#endif
 
-    // Prosta funkcja mieszajaca
-    int hash(int key) {
-        return abs(key) % capacity;
+    // Indeks kubelka klucza w biezacej tablicy
+    int hash(const K& key) const {
+        return policy(hasher(key));
     }
 
-    // Zmiana rozmiaru tablicy gdy wspolczynnik wypelnienia przekroczy prog
-    void resize() {
-        int oldCapacity = capacity;
-        Node** oldTable = table;
+    // Porzucenie wszystkich kubelkow. Gdy pula nie jest dzielona z migawka,
+    // a wezly maja trywialny destruktor (np. int -> int), wezly sa zwalniane
+    // naraz z cala pula, bez przechodzenia list.
+    void destroyNodes() {
+        if (pool.use_count() == 1 && is_trivially_destructible<Node>::value) {
+            table.release(false);
+            oldTable.release(false);
+            pool->releaseAll();
+        }
+        else {
+            table.release();
+            oldTable.release();
+        }
+    }
+
+    static void destroyList(Pool& nodePool, Node* head) {
+        while (head != nullptr) {
+            Node* next = head->next;
+            nodePool.deallocate(head);
+            head = next;
+        }
+    }
+
+    // Rozpoczecie przyrostowej zmiany rozmiaru
+    void startMigration() {
+        // Poprzednia migracja musi byc zakonczona
+        if (!oldTable.empty()) {
+            finishMigration();
+        }
+
+#ifdef HASH_TABLE_STATS
+        counters.resizes++;
+        RehashTimer timer(counters);
+#endif
+
+        oldTable = std::move(table);
+        oldCapacity = capacity;
+        oldPolicy = policy;
+        migrateIndex = 0;
 
         capacity *= 2;
-        table = new Node * [capacity];
-        for (int i = 0; i < capacity; i++) {
-            table[i] = nullptr;
+        table.allocate(capacity);
+        policy.setCapacity(capacity);
+    }
+
+    // Przeniesienie (przepiecie wezlow) kolejnych kubelkow starej tablicy
+    void migrateStep() {
+#ifdef HASH_TABLE_STATS
+        RehashTimer timer(counters);
+#endif
+
+        int end = migrateIndex + MIGRATE_STEP;
+        if (end > oldCapacity) {
+            end = oldCapacity;
         }
 
-        size = 0;
+        for (; migrateIndex < end; migrateIndex++) {
+            if (oldTable[migrateIndex] != nullptr) {
+                // Kubelek wspoldzielony z migawka jest najpierw kopiowany
+                Node*& head = oldTable.write(migrateIndex);
+                relinkList(head);
+                head = nullptr;
+            }
+        }
 
-        // Ponowne mieszanie wszystkich elementow
-        for (int i = 0; i < oldCapacity; i++) {
-            Node* current = oldTable[i];
-            while (current != nullptr) {
-                insert(current->key, current->value);
-                Node* temp = current;
-                current = current->next;
-                delete temp;
+        if (migrateIndex == oldCapacity) {
+            oldTable.release();
+        }
+    }
+
+    // Dokonczenie trwajacej migracji
+    void finishMigration() {
+        while (!oldTable.empty()) {
+            migrateStep();
+        }
+    }
+
+    // Wyszukanie wezla z kluczem w liscie o podanej glowie
+    Node* findInList(Node* current, const K& key) const {
+        while (current != nullptr) {
+            if (keyEqual(current->key, key)) {
+                return current;
             }
+            current = current->next;
         }
 
-        delete[] oldTable;
+        return nullptr;
     }
 
-    // DODANA funkcja pomocnicza do kopiowania listy
-    Node* copyList(Node* head) {
-        if (head == nullptr) return nullptr;
+    // Wyszukanie wezla w nieprzeniesionej jeszcze czesci starej tablicy
+    Node* findInOldTable(const K& key) const {
+        if (oldTable.empty()) {
+            return nullptr;
+        }
+
+        int oldIndex = oldPolicy(hasher(key));
+        if (oldIndex < migrateIndex) {
+            return nullptr;
+        }
+
+        return findInList(oldTable[oldIndex], key);
+    }
+
+    // Usuniecie klucza z listy o podanej glowie
+    bool removeFromList(Node*& head, const K& key) {
+        Node* current = head;
+        Node* prev = nullptr;
+
+        while (current != nullptr) {
+            if (keyEqual(current->key, key)) {
+                // Jesli to pierwszy wezel
+                if (prev == nullptr) {
+                    head = current->next;
+                }
+                else {
+                    prev->next = current->next;
+                }
 
-        Node* newHead = new Node(head->key, head->value);
-        Node* current = newHead;
-        Node* original = head->next;
+                pool->deallocate(current);
+                return true;
+            }
 
-        while (original != nullptr) {
-            current->next = new Node(original->key, original->value);
+            prev = current;
             current = current->next;
-            original = original->next;
         }
 
-        return newHead;
+        return false;
     }
 
-public:
-    HashTableChaining() {
-        capacity = 16;
-        size = 0;
-        table = new Node * [capacity];
-        for (int i = 0; i < capacity; i++) {
-            table[i] = nullptr;
+    // Wyszukanie wezla do zmiany w kubelku index; kubelek wspoldzielony
+    // z migawka jest kopiowany tylko wtedy, gdy klucz w nim jest
+    Node* findForWrite(Buckets& buckets, int index, const K& key) {
+        Node* node = findInList(buckets[index], key);
+        if (node != nullptr && buckets.isShared(index)) {
+            node = findInList(buckets.write(index), key);
         }
+        return node;
     }
 
-    // Konstruktor kopiujcy
-    HashTableChaining(const HashTableChaining& other) {
-        capacity = other.capacity;
-        size = other.size;
-        table = new Node * [capacity];
+    // Usuniecie klucza z kubelka index (kopiowanego jak w findForWrite)
+    bool removeFromBucket(Buckets& buckets, int index, const K& key) {
+        if (buckets.isShared(index) && findInList(buckets[index], key) == nullptr) {
+            return false;
+        }
+        return removeFromList(buckets.write(index), key);
+    }
 
-        for (int i = 0; i < capacity; i++) {
-            table[i] = copyList(other.table[i]);
+    // Przepiecie wszystkich wezlow listy do kubelkow biezacej tablicy
+    // (klucze sa unikalne, wiec nie trzeba sprawdzac duplikatow)
+    void relinkList(Node* head) {
+        Node* current = head;
+        while (current != nullptr) {
+            Node* next = current->next;
+            Node*& bucket = table.write(hash(current->key));
+            current->next = bucket;
+            bucket = current;
+            current = next;
         }
     }
 
-    // Operator przypisania
-    HashTableChaining& operator=(const HashTableChaining& other) {
-        if (this != &other) {
-            // Usu obecne dane
-            for (int i = 0; i < capacity; i++) {
-                Node* current = table[i];
-                while (current != nullptr) {
-                    Node* temp = current;
-                    current = current->next;
-                    delete temp;
-                }
+    // Najmniejsza pojemnosc (potega dwojki, co najmniej 16), przy ktorej
+    // expectedSize elementow nie przekracza progu wypelnienia
+    int capacityFor(int expectedSize) const {
+        int newCapacity = 16;
+        while (expectedSize > newCapacity * LOAD_FACTOR_THRESHOLD) {
+            newCapacity *= 2;
+        }
+        return newCapacity;
+    }
+
+    // Zmiana rozmiaru tablicy gdy wspolczynnik wypelnienia przekroczy prog
+    // (albo na zadanie reserve)
+    // Wezly sa przepinane do nowej tablicy w jednym przejsciu, bez
+    // przydzielania pamieci
+    void resize(int newCapacity) {
+#ifdef HASH_TABLE_STATS
+        counters.resizes++;
+        RehashTimer timer(counters);
+#endif
+
+        int previousCapacity = capacity;
+        Buckets previousTable = std::move(table);
+
+        capacity = newCapacity;
+        table.allocate(capacity);
+
+        policy.setCapacity(capacity);
+
+        // Ponowne mieszanie wszystkich elementow
+        for (int i = 0; i < previousCapacity; i++) {
+            if (previousTable[i] != nullptr) {
+                // Kubelek wspoldzielony z migawka jest najpierw kopiowany
+                Node*& head = previousTable.write(i);
+                relinkList(head);
+                head = nullptr;
             }
-            delete[] table;
+        }
+    }
 
-            // Skopiuj nowe dane
-            capacity = other.capacity;
-            size = other.size;
-            table = new Node * [capacity];
+    // DODANA funkcja pomocnicza do kopiowania listy
+    static Node* copyList(Pool& nodePool, Node* head) {
+        // Niekopiowalne wartosci nigdy nie sa kopiowane (brak migawek i kopii)
+        if constexpr (is_copy_constructible<V>::value) {
+            if (head == nullptr) return nullptr;
+
+            Node* newHead = nodePool.allocate(head->key, head->value);
+            Node* current = newHead;
+            Node* original = head->next;
 
-            for (int i = 0; i < capacity; i++) {
-                table[i] = copyList(other.table[i]);
+            while (original != nullptr) {
+                current->next = nodePool.allocate(original->key, original->value);
+                current = current->next;
+                original = original->next;
             }
+
+            return newHead;
+        }
+        else {
+            return nullptr;
         }
-        return *this;
     }
 
-    ~HashTableChaining() {
+    // Wyszukanie wezla z kluczem w obu tablicach
+    Node* findNode(const K& key) const {
+        if (capacity == 0) {
+            return nullptr;
+        }
+
+        Node* node = findInList(table[hash(key)], key);
+        if (node != nullptr) {
+            return node;
+        }
+
+        // W trakcie migracji klucz moze byc jeszcze w starej tablicy
+        return findInOldTable(key);
+    }
+
+    // Pierwsze dwa etapy operacji wsadowej dla porcji kluczy [start, end):
+    // policzenie indeksow i pobranie kubelkow, a potem pobranie pierwszych
+    // wezlow list (adres wezla jest znany dopiero po wczytaniu kubelka)
+    void prefetchBuckets(const K* keys, int start, int end, int* indices) const {
+        for (int i = start; i < end; i++) {
+            indices[i - start] = hash(keys[i]);
+            prefetchRead(&table[indices[i - start]]);
+        }
+
+        for (int i = start; i < end; i++) {
+            Node* head = table[indices[i - start]];
+            if (head != nullptr) {
+                prefetchRead(head);
+            }
+        }
+    }
+
+    // Skopiowanie zawartosci innej tablicy (migracja w kopii jest od razu konczona)
+    // Kopia dostaje wlasna pule wezlow.
+    void copyFrom(const HashTableChaining& other) {
+        pool = make_shared<Pool>();
+        table.setOps(BucketOps(pool.get()));
+        oldTable.setOps(BucketOps(pool.get()));
+
+        capacity = other.capacity;
+        size = other.size;
+        table.allocate(capacity);
+        hasher = other.hasher;
+        keyEqual = other.keyEqual;
+        policy = other.policy;
+        incrementalResize = other.incrementalResize;
+        oldTable.release();
+        oldCapacity = 0;
+        migrateIndex = 0;
+
         for (int i = 0; i < capacity; i++) {
-            Node* current = table[i];
-            while (current != nullptr) {
-                Node* temp = current;
-                current = current->next;
-                delete temp;
+            if (other.table[i] != nullptr) {
+                table.write(i) = copyList(*pool, other.table[i]);
+            }
+        }
+
+        // Elementy, ktorych migracja jeszcze nie przeniosla
+        if (!other.oldTable.empty()) {
+            for (int i = other.migrateIndex; i < other.oldCapacity; i++) {
+                for (Node* current = other.oldTable[i]; current != nullptr; current = current->next) {
+                    Node* newNode = pool->allocate(current->key, current->value);
+                    Node*& bucket = table.write(hash(current->key));
+                    newNode->next = bucket;
+                    bucket = newNode;
+                }
             }
         }
-        delete[] table;
     }
 
-    // Wstawianie pary klucz-wartosc
-    void insert(int key, int value) {
+    // Wspolna czesc insert i emplace; Overwrite - czy nadpisac istniejaca wartosc.
+    // Zwraca true, jesli klucz zostal dodany.
+    template <bool Overwrite, typename... Args>
+    bool insertImpl(const K& key, Args&&... args) {
+        // Przeniesienie kolejnej porcji starej tablicy
+        if (!oldTable.empty()) {
+            migrateStep();
+        }
+
         // Sprawdzenie czy potrzebna jest zmiana rozmiaru
-        if ((double)size / capacity >= LOAD_FACTOR_THRESHOLD) {
-            resize();
+        // (przy pojemnosci 0 warunek jest zawsze spelniony)
+        if (size >= capacity * LOAD_FACTOR_THRESHOLD) {
+            if (capacity == 0) {
+                init(16, incrementalResize);
+            }
+            else if (incrementalResize) {
+                startMigration();
+            }
+            else {
+                resize(capacity * 2);
+            }
         }
 
+        return insertUnchecked<Overwrite>(key, std::forward<Args>(args)...);
+    }
+
+    // Wstawienie bez sprawdzania progu wypelnienia (i bez kroku migracji)
+    template <bool Overwrite, typename... Args>
+    bool insertUnchecked(const K& key, Args&&... args) {
         int index = hash(key);
 
         // Sprawdzenie czy klucz juz istnieje
-        Node* current = table[index];
-        while (current != nullptr) {
-            if (current->key == key) {
-                current->value = value;
-                return;
+        if (findInList(table[index], key) != nullptr) {
+            if constexpr (Overwrite) {
+                findForWrite(table, index, key)->value = V(std::forward<Args>(args)...);
             }
-            current = current->next;
+            return false;
+        }
+
+        // W trakcie migracji klucz moze byc jeszcze w starej tablicy
+        if (findInOldTable(key) != nullptr) {
+            if constexpr (Overwrite) {
+                findForWrite(oldTable, oldPolicy(hasher(key)), key)->value = V(std::forward<Args>(args)...);
+            }
+            return false;
         }
 
         // Dodanie nowego wezla na poczatek listy
-        Node* newNode = new Node(key, value);
-        newNode->next = table[index];
-        table[index] = newNode;
+        Node* newNode = pool->allocate(key, std::forward<Args>(args)...);
+        Node*& bucket = table.write(index);
+        newNode->next = bucket;
+        bucket = newNode;
         size++;
+        return true;
+    }
+
+    // Wspolna czesc konstruktorow
+    void init(int initialCapacity, bool incrementalMode) {
+        pool = make_shared<Pool>();
+        table.setOps(BucketOps(pool.get()));
+        oldTable.setOps(BucketOps(pool.get()));
+
+        incrementalResize = incrementalMode;
+        oldTable.release();
+        oldCapacity = 0;
+        migrateIndex = 0;
+        capacity = initialCapacity;
+        size = 0;
+        table.allocate(capacity);
+        policy.setCapacity(capacity);
+    }
+
+    // Przejecie zawartosci innej tablicy; tamta zostaje pusta, bez kubelkow
+    // i puli (bez przydzialu pamieci - dostanie je przy pierwszym wstawieniu)
+    void moveFrom(HashTableChaining& other) noexcept {
+        pool = std::move(other.pool);
+        table = std::move(other.table);
+        capacity = other.capacity;
+        size = other.size;
+        hasher = std::move(other.hasher);
+        keyEqual = std::move(other.keyEqual);
+        policy = other.policy;
+        incrementalResize = other.incrementalResize;
+        oldTable = std::move(other.oldTable);
+        oldCapacity = other.oldCapacity;
+        migrateIndex = other.migrateIndex;
+        oldPolicy = other.oldPolicy;
+
+        other.capacity = 0;
+        other.size = 0;
+        other.oldCapacity = 0;
+        other.migrateIndex = 0;
+    }
+
+    // Znacznik konstruktora migawki
+    struct SnapshotTag {};
+
+    // Znacznik konstruktora tablicy z przyrostowa zmiana rozmiaru
+    struct IncrementalTag {};
+
+    HashTableChaining(int expectedSize, IncrementalTag) {
+        init(capacityFor(expectedSize), true);
+    }
+
+    // Migawka - wszystkie pola kopiowane, pula i segmenty kubelkow wspoldzielone
+    HashTableChaining(const HashTableChaining& other, SnapshotTag)
+        : pool(other.pool), table(other.table), capacity(other.capacity), size(other.size),
+        hasher(other.hasher), keyEqual(other.keyEqual), policy(other.policy),
+        incrementalResize(other.incrementalResize), oldTable(other.oldTable),
+        oldCapacity(other.oldCapacity), migrateIndex(other.migrateIndex), oldPolicy(other.oldPolicy) {}
+
+public:
+    HashTableChaining() {
+        init(16, false);
+    }
+
+    // Tablica od razu dopasowana do expectedSize elementow
+    explicit HashTableChaining(int expectedSize) {
+        init(capacityFor(expectedSize), false);
+    }
+
+    // Dawny HashTableChaining(true) nie moze po cichu oznaczac pojemnosci dla 1 elementu
+    template <typename T, typename = enable_if_t<is_same<T, bool>::value>>
+    explicit HashTableChaining(T) = delete;
+
+    // Tablica z przyrostowa zmiana rozmiaru zamiast jednorazowej
+    // (nazwana funkcja zamiast konstruktora z bool, ktory mylilby sie
+    // z konstruktorem przyjmujacym liczbe elementow)
+    static HashTableChaining incremental(int expectedSize = 0) {
+        return HashTableChaining(expectedSize, IncrementalTag());
+    }
+
+    // Konstruktor kopiujcy
+    HashTableChaining(const HashTableChaining& other) {
+        copyFrom(other);
+    }
+
+    // Konstruktor przenoszacy
+    HashTableChaining(HashTableChaining&& other) noexcept {
+        moveFrom(other);
+    }
+
+    // Operator przypisania
+    HashTableChaining& operator=(const HashTableChaining& other) {
+        if (this != &other) {
+            // Usu obecne dane (wszystkie wezly naraz z puli)
+            destroyNodes();
+
+            // Skopiuj nowe dane
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    // Przenoszacy operator przypisania
+    HashTableChaining& operator=(HashTableChaining&& other) noexcept {
+        if (this != &other) {
+            destroyNodes();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    // Pamiec wezlow zwalnia pula
+    ~HashTableChaining() {
+        destroyNodes();
+    }
+
+    // Migawka tablicy w czasie O(1). Migawka i oryginal dziela segmenty kubelkow
+    // i pule wezlow; pierwszy zapis do segmentu (w dowolnej z nich) kopiuje
+    // tylko ten segment razem z jego listami. Migawke mozna czytac z innego
+    // watku, ale tworzyc i niszczyc tylko w watku, ktory zapisuje do oryginalu.
+    HashTableChaining snapshot() const {
+        static_assert(is_copy_constructible<V>::value, "snapshot() wymaga kopiowalnych wartosci");
+        return HashTableChaining(*this, SnapshotTag());
+    }
+
+    // Wstawianie pary klucz-wartosc (istniejaca wartosc jest nadpisywana)
+    void insert(const K& key, V value) {
+        insertImpl<true>(key, std::move(value));
+    }
+
+    // Wstawienie wartosci zbudowanej w miejscu z args, jesli klucza nie ma
+    // w tablicy. Zwraca true, jesli klucz zostal dodany.
+    template <typename... Args>
+    bool emplace(const K& key, Args&&... args) {
+        return insertImpl<false>(key, std::forward<Args>(args)...);
     }
 
     // Usuwanie pary klucz-wartosc
-    bool remove(int key) {
-        int index = hash(key);
+    bool remove(const K& key) {
+        if (capacity == 0) {
+            return false;
+        }
 
-        Node* current = table[index];
-        Node* prev = nullptr;
+        if (!oldTable.empty()) {
+            migrateStep();
+        }
 
-        while (current != nullptr) {
-            if (current->key == key) {
-                // Jesli to pierwszy wezel
-                if (prev == nullptr) {
-                    table[index] = current->next;
-                }
-                else {
-                    prev->next = current->next;
-                }
+        if (removeFromBucket(table, hash(key), key)) {
+            size--;
+            return true;
+        }
 
-                delete current;
+        // W trakcie migracji klucz moze byc jeszcze w starej tablicy
+        if (!oldTable.empty()) {
+            int oldIndex = oldPolicy(hasher(key));
+            if (oldIndex >= migrateIndex && removeFromBucket(oldTable, oldIndex, key)) {
                 size--;
                 return true;
             }
-
-            prev = current;
-            current = current->next;
         }
 
         return false;
     }
 
-    // Pobieranie wartosci dla klucza
-    int get(int key) {
-        int index = hash(key);
+    // Wskaznik na wartosc dla klucza (nullptr gdy brak). Wartosc moze byc
+    // zmieniana, wiec gdy klucz jest w kubelku wspoldzielonym z migawka,
+    // segment kubelka jest najpierw kopiowany. Sam odczyt powinien isc przez
+    // const find() albo get(), ktore niczego nie kopiuja.
+    V* find(const K& key) {
+        if (capacity == 0) {
+            return nullptr;
+        }
 
-        Node* current = table[index];
-        while (current != nullptr) {
-            if (current->key == key) {
-                return current->value;
+        Node* node = findForWrite(table, hash(key), key);
+        if (node == nullptr && findInOldTable(key) != nullptr) {
+            node = findForWrite(oldTable, oldPolicy(hasher(key)), key);
+        }
+        return node != nullptr ? &node->value : nullptr;
+    }
+
+    const V* find(const K& key) const {
+        Node* node = findNode(key);
+        return node != nullptr ? &node->value : nullptr;
+    }
+
+    // Pobieranie kopii wartosci dla klucza
+    optional<V> get(const K& key) const {
+        const V* value = find(key);
+        if (value == nullptr) {
+            return nullopt;
+        }
+        return *value;
+    }
+
+    // Dopasowanie pojemnosci tak, zeby n elementow miescilo sie bez zmiany
+    // rozmiaru. Trwajaca migracja jest konczona. Tablica nigdy sie nie zmniejsza.
+    void reserve(int n) {
+        if (capacity == 0) {
+            init(capacityFor(n), incrementalResize);
+            return;
+        }
+
+        finishMigration();
+
+        int newCapacity = capacityFor(n);
+        if (newCapacity > capacity) {
+            resize(newCapacity);
+        }
+    }
+
+    // Wstawienie count par (keys[i], values[i]) z jednorazowym dopasowaniem
+    // pojemnosci - bez sprawdzania progu przy kazdym wstawieniu
+    void build(const K* keys, const V* values, int count) {
+        reserve(size + count);
+
+        for (int i = 0; i < count; i++) {
+            insertUnchecked<true>(keys[i], values[i]);
+        }
+    }
+
+    // Wsadowe wstawianie count par (keys[i], values[i]).
+    // Indeks jest liczony w insert ponownie, bo wstawienie moze zmienic
+    // rozmiar tablicy - pobrane kubelki przyspieszaja wtedy tylko reszte porcji.
+    void insertBatch(const K* keys, const V* values, int count) {
+        if (capacity == 0) {
+            init(16, incrementalResize);
+        }
+
+        int indices[BATCH_BLOCK];
+
+        for (int start = 0; start < count; start += BATCH_BLOCK) {
+            int end = min(start + BATCH_BLOCK, count);
+            prefetchBuckets(keys, start, end, indices);
+
+            for (int i = start; i < end; i++) {
+                insertImpl<true>(keys[i], values[i]);
             }
-            current = current->next;
         }
+    }
+
+    // Wsadowe wyszukiwanie count kluczy; results[i] dostaje kopie wartosci
+    // albo nullopt. Zwraca liczbe znalezionych kluczy.
+    int getBatch(const K* keys, int count, optional<V>* results) const {
+        if (capacity == 0) {
+            fill(results, results + count, nullopt);
+            return 0;
+        }
+
+        int indices[BATCH_BLOCK];
+        int found = 0;
 
-        return -1;
+        for (int start = 0; start < count; start += BATCH_BLOCK) {
+            int end = min(start + BATCH_BLOCK, count);
+            prefetchBuckets(keys, start, end, indices);
+
+            for (int i = start; i < end; i++) {
+                Node* node = findInList(table[indices[i - start]], keys[i]);
+                if (node == nullptr) {
+                    node = findInOldTable(keys[i]);
+                }
+
+                if (node != nullptr) {
+                    results[i] = node->value;
+                    found++;
+                }
+                else {
+                    results[i] = nullopt;
+                }
+            }
+        }
+
+        return found;
+    }
+
+    // Wsadowe usuwanie count kluczy. Zwraca liczbe usunietych kluczy.
+    int removeBatch(const K* keys, int count) {
+        if (capacity == 0) {
+            return 0;
+        }
+
+        int removed = 0;
+
+        // Migracja przenosi kubelki przy kazdym usunieciu - bez wsadu
+        if (!oldTable.empty()) {
+            for (int i = 0; i < count; i++) {
+                if (remove(keys[i])) {
+                    removed++;
+                }
+            }
+            return removed;
+        }
+
+        int indices[BATCH_BLOCK];
+
+        for (int start = 0; start < count; start += BATCH_BLOCK) {
+            int end = min(start + BATCH_BLOCK, count);
+            prefetchBuckets(keys, start, end, indices);
+
+            for (int i = start; i < end; i++) {
+                if (removeFromBucket(table, indices[i - start], keys[i])) {
+                    size--;
+                    removed++;
+                }
+            }
+        }
+
+        return removed;
     }
 
     // Czyszczenie tablicy mieszajacej
     void clear() {
-        for (int i = 0; i < capacity; i++) {
-            Node* current = table[i];
-            while (current != nullptr) {
-                Node* temp = current;
-                current = current->next;
-                delete temp;
-            }
-            table[i] = nullptr;
+        if (pool == nullptr) {
+            init(16, incrementalResize);
+            return;
         }
 
-        delete[] table;
+        destroyNodes();
+
         capacity = 16;
         size = 0;
-        table = new Node * [capacity];
-        for (int i = 0; i < capacity; i++) {
-            table[i] = nullptr;
-        }
+        table.allocate(capacity);
+        policy.setCapacity(capacity);
     }
 
     // Pobieranie aktualnego rozmiaru
-    int getSize() {
+    int getSize() const {
         return size;
     }
+
+    // Pojemnosc tablicy (liczba kubelkow)
+    int getCapacity() const {
+        return capacity;
+    }
+
+    // Statystyki struktury: rozklad dlugosci list w kubelkach (razem
+    // z pustymi). W trakcie migracji uwzglednia tez nieprzeniesione
+    // kubelki starej tablicy.
+    TableStats getStats() const {
+        TableStats stats;
+        stats.size = size;
+        stats.capacity = capacity;
+        stats.nodeBytes = pool != nullptr ? pool->getStats().bytes : 0;
+
+        for (int i = 0; i < capacity; i++) {
+            int length = 0;
+            for (Node* current = table[i]; current != nullptr; current = current->next) {
+                length++;
+            }
+            stats.chainLengths.add(length);
+        }
+
+        for (int i = migrateIndex; i < oldCapacity && !oldTable.empty(); i++) {
+            int length = 0;
+            for (Node* current = oldTable[i]; current != nullptr; current = current->next) {
+                length++;
+            }
+            stats.chainLengths.add(length);
+        }
+
+#ifdef HASH_TABLE_STATS
+        counters.fill(stats);
+#endif
+        return stats;
+    }
+
+    // Statystyki puli wezlow
+    PoolStats getPoolStats() const {
+        return pool != nullptr ? pool->getStats() : PoolStats();
+    }
 };
 
 #endif
@@ -0,0 +1,610 @@
+#ifndef COMPACT_AVL_TREE_HPP
+#define COMPACT_AVL_TREE_HPP
+
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include <utility>
+#include <type_traits>
+#include <cstdint>
+#include "node_pool.hpp"
+#include "prefetch.hpp"
+
+using namespace std;
+
+// Drzewo AVL o zwartych wezlach - kubelek tablicy HashTableAVL zamiast
+// AVLTree (parametr Bucket tablicy). Wezly wszystkich drzew tablicy leza
+// w jednym ciaglym wektorze (arenie), a dzieci sa wskazywane 32-bitowymi
+// indeksami. Wspolczynnik zbalansowania zajmuje najstarsze bity indeksow
+// dzieci, wiec wezel int/int ma 16 bajtow zamiast 32. Kopia calej areny to
+// jedno skopiowanie pamieci (dla trywialnie kopiowalnych par).
+// Wzrost areny przenosi wezly: wskaznik zwrocony przez find() jest wazny
+// do nastepnego wstawienia, a migawke tablicy mozna czytac tylko w watku,
+// ktory zapisuje do oryginalu. Arena miesci do 2^31 - 1 wezlow.
+// K, V - typy klucza i wartosci, Compare - porzadek kluczy
+template <typename K = int, typename V = int, typename Compare = less<K>>
+class CompactAVLTree {
+private:
+    static const uint32_t NIL = 0x7FFFFFFF;          // brak wezla
+    static const uint32_t INDEX_MASK = 0x7FFFFFFF;
+    static const uint32_t HEAVY = 0x80000000;        // poddrzewo po tej stronie jest wyzsze
+
+    // Wezel areny. Zwolniony wezel trzyma stara pare az do ponownego uzycia,
+    // a left wskazuje nastepny wolny wezel.
+    struct Node {
+        K key;
+        V value;
+        uint32_t left;    // indeks lewego dziecka | HEAVY, gdy lewe poddrzewo wyzsze
+        uint32_t right;   // indeks prawego dziecka | HEAVY, gdy prawe poddrzewo wyzsze
+
+        template <typename... Args>
+        Node(const K& k, Args&&... args) : key(k), value(std::forward<Args>(args)...), left(NIL), right(NIL) {}
+    };
+
+public:
+    // Arena wezlow wspolna dla wszystkich drzew jednej tablicy; zwolnione
+    // wezly trafiaja na liste wolnych indeksow
+    class Pool {
+    private:
+        friend class CompactAVLTree;
+
+        vector<Node> nodes;
+        uint32_t freeList;
+        long long freeListed;
+        long long allocations;
+
+        template <typename... Args>
+        uint32_t allocate(const K& key, Args&&... args) {
+            allocations++;
+            if (freeList != NIL) {
+                uint32_t index = freeList;
+                Node& node = nodes[index];
+                freeList = node.left;
+                freeListed--;
+                node.key = key;
+                node.value = V(std::forward<Args>(args)...);
+                node.left = NIL;
+                node.right = NIL;
+                return index;
+            }
+
+            nodes.emplace_back(key, std::forward<Args>(args)...);
+            return (uint32_t)(nodes.size() - 1);
+        }
+
+        void deallocate(uint32_t index) {
+            nodes[index].left = freeList;
+            freeList = index;
+            freeListed++;
+        }
+
+    public:
+        Pool() : freeList(NIL), freeListed(0), allocations(0) {}
+
+        // Oddanie calej pamieci areny (drzewa przestaja byc wazne)
+        void releaseAll() {
+            vector<Node>().swap(nodes);
+            freeList = NIL;
+            freeListed = 0;
+        }
+
+        // Arena jako pula z jednym blokiem
+        PoolStats getStats() const {
+            PoolStats stats;
+            stats.slabs = nodes.capacity() > 0 ? 1 : 0;
+            stats.capacity = (long long)nodes.capacity();
+            stats.inUse = (long long)nodes.size() - freeListed;
+            stats.freeListed = freeListed;
+            stats.allocations = allocations;
+            stats.bytes = (long long)nodes.capacity() * (long long)sizeof(Node);
+            return stats;
+        }
+    };
+
+private:
+    uint32_t root;
+    int size;
+    Pool* pool;       // arena tablicy albo wlasna arena drzewa
+    bool ownsPool;    // drzewo bez setPool() tworzy arene przy pierwszym wstawieniu
+    Compare compare;
+
+    // Najwieksza wysokosc drzewa AVL o co najwyzej 2^31 wezlach to 45
+    static const int MAX_HEIGHT = 48;
+
+    Node& at(uint32_t index) const {
+        return pool->nodes[index];
+    }
+
+    uint32_t leftOf(uint32_t index) const {
+        return at(index).left & INDEX_MASK;
+    }
+
+    uint32_t rightOf(uint32_t index) const {
+        return at(index).right & INDEX_MASK;
+    }
+
+    void setLeft(uint32_t index, uint32_t child) {
+        Node& node = at(index);
+        node.left = (node.left & HEAVY) | child;
+    }
+
+    void setRight(uint32_t index, uint32_t child) {
+        Node& node = at(index);
+        node.right = (node.right & HEAVY) | child;
+    }
+
+    // Wysokosc lewego poddrzewa minus wysokosc prawego (-1, 0, 1)
+    int balanceOf(uint32_t index) const {
+        const Node& node = at(index);
+        return (int)(node.left >> 31) - (int)(node.right >> 31);
+    }
+
+    void setBalance(uint32_t index, int balance) {
+        Node& node = at(index);
+        node.left = (node.left & INDEX_MASK) | (balance > 0 ? HEAVY : 0);
+        node.right = (node.right & INDEX_MASK) | (balance < 0 ? HEAVY : 0);
+    }
+
+    void setChild(uint32_t index, bool left, uint32_t child) {
+        if (left) {
+            setLeft(index, child);
+        }
+        else {
+            setRight(index, child);
+        }
+    }
+
+    // Podpiecie poddrzewa w miejscu wezla z pozycji i sciezki (w korzeniu,
+    // gdy i == 0, inaczej pod wezlem path[i - 1])
+    void replaceAt(const uint32_t path[], const bool wentLeft[], int i, uint32_t subtree) {
+        if (i == 0) {
+            root = subtree;
+        }
+        else {
+            setChild(path[i - 1], wentLeft[i - 1], subtree);
+        }
+    }
+
+    // Przydzielenie nowego wezla
+    template <typename... Args>
+    uint32_t newNode(const K& key, Args&&... args) {
+        if (pool == nullptr) {
+            pool = new Pool();
+            ownsPool = true;
+        }
+        return pool->allocate(key, std::forward<Args>(args)...);
+    }
+
+    // Przywrocenie zbalansowania wezla, ktorego wspolczynnik wynosi balance
+    // (+-2, nie mieszczacy sie w bitach wezla); zwraca nowy korzen poddrzewa.
+    // Wspolczynniki po rotacji wynikaja ze wspolczynnikow dzieci.
+    uint32_t rebalance(uint32_t index, int balance) {
+        if (balance > 0) {
+            uint32_t left = leftOf(index);
+            int leftBalance = balanceOf(left);
+
+            if (leftBalance >= 0) {
+                // Przypadek Lewy-Lewy: rotacja w prawo
+                setLeft(index, rightOf(left));
+                setRight(left, index);
+                setBalance(index, leftBalance == 0 ? 1 : 0);
+                setBalance(left, leftBalance == 0 ? -1 : 0);
+                return left;
+            }
+
+            // Przypadek Lewy-Prawy: podwojna rotacja wokol prawego wnuka
+            uint32_t middle = rightOf(left);
+            int middleBalance = balanceOf(middle);
+            setRight(left, leftOf(middle));
+            setLeft(index, rightOf(middle));
+            setLeft(middle, left);
+            setRight(middle, index);
+            setBalance(left, middleBalance < 0 ? 1 : 0);
+            setBalance(index, middleBalance > 0 ? -1 : 0);
+            setBalance(middle, 0);
+            return middle;
+        }
+
+        uint32_t right = rightOf(index);
+        int rightBalance = balanceOf(right);
+
+        if (rightBalance <= 0) {
+            // Przypadek Prawy-Prawy: rotacja w lewo
+            setRight(index, leftOf(right));
+            setLeft(right, index);
+            setBalance(index, rightBalance == 0 ? -1 : 0);
+            setBalance(right, rightBalance == 0 ? 1 : 0);
+            return right;
+        }
+
+        // Przypadek Prawy-Lewy
+        uint32_t middle = leftOf(right);
+        int middleBalance = balanceOf(middle);
+        setLeft(right, rightOf(middle));
+        setRight(index, leftOf(middle));
+        setRight(middle, right);
+        setLeft(middle, index);
+        setBalance(right, middleBalance > 0 ? -1 : 0);
+        setBalance(index, middleBalance < 0 ? 1 : 0);
+        setBalance(middle, 0);
+        return middle;
+    }
+
+    // Zejscie od korzenia do miejsca klucza; path i wentLeft - wezly sciezki
+    // i strona, w ktora od nich zeszlo, depth - ich liczba. Zwraca wezel
+    // z kluczem albo NIL (nowy wezel trafia wtedy pod path[depth - 1]).
+    uint32_t findPath(const K& key, uint32_t path[], bool wentLeft[], int& depth) const {
+        depth = 0;
+        uint32_t index = root;
+        while (index != NIL) {
+            const Node& node = at(index);
+            if (compare(key, node.key)) {
+                path[depth] = index;
+                wentLeft[depth++] = true;
+                index = node.left & INDEX_MASK;
+            }
+            else if (compare(node.key, key)) {
+                path[depth] = index;
+                wentLeft[depth++] = false;
+                index = node.right & INDEX_MASK;
+            }
+            else {
+                break;
+            }
+        }
+        return index;
+    }
+
+    // Podpiecie nowego liscia na koncu sciezki i powrot w gore, dopoki
+    // wysokosc poddrzewa rosnie
+    void attachLeaf(const uint32_t path[], const bool wentLeft[], int depth, uint32_t leaf) {
+        replaceAt(path, wentLeft, depth, leaf);
+        size++;
+
+        for (int i = depth - 1; i >= 0; i--) {
+            int balance = balanceOf(path[i]) + (wentLeft[i] ? 1 : -1);
+
+            if (balance == 2 || balance == -2) {
+                // Po rotacji poddrzewo ma wysokosc sprzed wstawienia
+                replaceAt(path, wentLeft, i, rebalance(path[i], balance));
+                break;
+            }
+            setBalance(path[i], balance);
+            if (balance == 0) {
+                break;   // Nizsza strona wyrownana, wysokosc bez zmian
+            }
+        }
+    }
+
+    // Wstawianie wezla do drzewa AVL
+    // overwrite - czy nadpisac wartosc istniejacego klucza. Zwraca true, jesli dodano wezel.
+    template <typename... Args>
+    bool insertNode(const K& key, bool overwrite, Args&&... args) {
+        uint32_t path[MAX_HEIGHT];
+        bool wentLeft[MAX_HEIGHT];
+        int depth;
+        uint32_t index = findPath(key, path, wentLeft, depth);
+
+        if (index != NIL) {
+            // Klucz juz istnieje, aktualizacja wartosci
+            if (overwrite) {
+                at(index).value = V(std::forward<Args>(args)...);
+            }
+            return false;
+        }
+
+        // Przydzial moze przeniesc arene - sciezka trzyma indeksy, nie adresy
+        attachLeaf(path, wentLeft, depth, newNode(key, std::forward<Args>(args)...));
+        return true;
+    }
+
+    // Dolaczenie gotowego wezla; wezel z kluczem juz obecnym w drzewie jest zwalniany
+    void attachNode(uint32_t index) {
+        uint32_t path[MAX_HEIGHT];
+        bool wentLeft[MAX_HEIGHT];
+        int depth;
+
+        if (findPath(at(index).key, path, wentLeft, depth) != NIL) {
+            pool->deallocate(index);
+            return;
+        }
+
+        at(index).left = NIL;
+        at(index).right = NIL;
+        attachLeaf(path, wentLeft, depth, index);
+    }
+
+    // Dopisanie wezla na poczatek budowanego ciagu (lista przez right, od
+    // najwiekszego klucza - dopisywane sa rosnaco)
+    void pushNode(uint32_t index) {
+        at(index).left = NIL;
+        at(index).right = root;
+        root = index;
+        size++;
+    }
+
+    // Zbudowanie idealnie zbalansowanego poddrzewa z count kolejnych wezlow
+    // listy (malejaco przez right); height - wysokosc wyniku
+    uint32_t buildBalanced(uint32_t& list, int count, int& height) {
+        if (count == 0) {
+            height = 0;
+            return NIL;
+        }
+
+        // Najpierw wieksze klucze, czyli prawe poddrzewo
+        int rightHeight;
+        int leftHeight;
+        uint32_t right = buildBalanced(list, count / 2, rightHeight);
+        uint32_t index = list;
+        list = at(list).right;
+        uint32_t left = buildBalanced(list, count - 1 - count / 2, leftHeight);
+
+        at(index).left = left;
+        at(index).right = right;
+        setBalance(index, leftHeight - rightHeight);
+        height = 1 + max(leftHeight, rightHeight);
+        return index;
+    }
+
+    // Usuniecie wezla z drzewa AVL. Zwraca true, jesli klucz byl w drzewie.
+    bool deleteNode(const K& key) {
+        uint32_t path[MAX_HEIGHT];
+        bool wentLeft[MAX_HEIGHT];
+        int depth;
+        uint32_t target = findPath(key, path, wentLeft, depth);
+        if (target == NIL) {
+            return false;
+        }
+
+        // Wezel z dwojgiem dzieci: dane nastepnika w porzadku inorder trafiaja
+        // do tego wezla, a usuwany jest nastepnik (ma co najwyzej prawe dziecko)
+        if (leftOf(target) != NIL && rightOf(target) != NIL) {
+            path[depth] = target;
+            wentLeft[depth++] = false;
+            uint32_t successor = rightOf(target);
+
+            while (leftOf(successor) != NIL) {
+                path[depth] = successor;
+                wentLeft[depth++] = true;
+                successor = leftOf(successor);
+            }
+
+            at(target).key = std::move(at(successor).key);
+            at(target).value = std::move(at(successor).value);
+            target = successor;
+        }
+
+        // Wezel z jednym dzieckiem lub bez dzieci
+        replaceAt(path, wentLeft, depth, leftOf(target) != NIL ? leftOf(target) : rightOf(target));
+        pool->deallocate(target);
+        size--;
+
+        // Powrot w gore sciezki, dopoki wysokosc poddrzewa maleje
+        for (int i = depth - 1; i >= 0; i--) {
+            int balance = balanceOf(path[i]) + (wentLeft[i] ? -1 : 1);
+
+            if (balance == 2 || balance == -2) {
+                uint32_t subtree = rebalance(path[i], balance);
+                replaceAt(path, wentLeft, i, subtree);
+                // Rotacja wokol dziecka o wspolczynniku 0 nie zmniejsza wysokosci
+                if (balanceOf(subtree) != 0) {
+                    break;
+                }
+                continue;
+            }
+            setBalance(path[i], balance);
+            if (balance != 0) {
+                break;   // Wczesniej rowne strony, wysokosc bez zmian
+            }
+        }
+        return true;
+    }
+
+    // Wyszukiwanie klucza w drzewie AVL
+    uint32_t search(const K& key) const {
+        if (root == NIL) {
+            return NIL;
+        }
+
+        const Node* nodes = pool->nodes.data();
+        uint32_t index = root;
+        while (index != NIL) {
+            const Node& node = nodes[index];
+            if (compare(node.key, key)) {
+                index = node.right & INDEX_MASK;
+            }
+            else if (compare(key, node.key)) {
+                index = node.left & INDEX_MASK;
+            }
+            else {
+                return index;
+            }
+        }
+        return NIL;
+    }
+
+    // Rozebranie drzewa w porzadku inorder bez stosu (jak w AVLTree).
+    // visit przejmuje kazdy wezel (zwalnia go albo przenosi).
+    template <typename Visit>
+    void dismantle(Visit visit) {
+        uint32_t index = root;
+        while (index != NIL) {
+            uint32_t left = leftOf(index);
+            if (left != NIL) {
+                at(index).left = rightOf(left);
+                at(left).right = index;
+                index = left;
+            }
+            else {
+                uint32_t right = rightOf(index);
+                visit(index);
+                index = right;
+            }
+        }
+        root = NIL;
+        size = 0;
+    }
+
+public:
+    CompactAVLTree() : root(NIL), size(0), pool(nullptr), ownsPool(false) {}
+
+    // Ustawienie areny wezlow (tylko dla pustego drzewa)
+    void setPool(Pool* nodePool) {
+        pool = nodePool;
+    }
+
+    // Przejecie korzenia i rozmiaru drzewa z kopii calej areny, w ktorej
+    // wezly maja te same indeksy (arena tego drzewa musi byc juz ustawiona)
+    void copyRoot(const CompactAVLTree& other) {
+        root = other.root;
+        size = other.size;
+    }
+
+    // Odwiedzenie wszystkich par w porzadku kluczy: visit(key, value)
+    template <typename Visit>
+    void forEach(Visit visit) const {
+        uint32_t stack[MAX_HEIGHT];
+        int depth = 0;
+        uint32_t index = root;
+
+        while (index != NIL || depth > 0) {
+            while (index != NIL) {
+                stack[depth++] = index;
+                index = leftOf(index);
+            }
+            index = stack[--depth];
+            visit(static_cast<const K&>(at(index).key), static_cast<const V&>(at(index).value));
+            index = rightOf(index);   // visit mogl przeniesc arene (kopia do drzewa tej samej areny)
+        }
+    }
+
+    // Przekazanie wszystkich par w porzadku kluczy: visit(K&& key, V&& value);
+    // wezly sa zwalniane po drodze, drzewo zostaje puste
+    template <typename Visit>
+    void drain(Visit visit) {
+        dismantle([&](uint32_t index) {
+            // Para wyjeta z areny przed visit, ktory moze ja przeniesc
+            K key = std::move(at(index).key);
+            V value = std::move(at(index).value);
+            pool->deallocate(index);
+            visit(std::move(key), std::move(value));
+        });
+    }
+
+    // Budowa drzewa z ciagu posortowanego w czasie O(n) - jak w AVLTree:
+    // pushSorted() z rosnacymi kluczami (albo distribute()), potem finishSorted()
+    template <typename... Args>
+    void pushSorted(const K& key, Args&&... args) {
+        pushNode(newNode(key, std::forward<Args>(args)...));
+    }
+
+    // Zamiana ciagu z pushSorted() w drzewo idealnie zbalansowane. Ciag,
+    // ktory nie okazal sie rosnacy, jest wstawiany wezel po wezle.
+    void finishSorted() {
+        uint32_t list = root;
+        bool sorted = true;
+        for (uint32_t index = list; index != NIL && rightOf(index) != NIL; index = rightOf(index)) {
+            if (!compare(at(rightOf(index)).key, at(index).key)) {
+                sorted = false;
+                break;
+            }
+        }
+
+        root = NIL;
+        if (sorted) {
+            int height;
+            root = buildBalanced(list, size, height);
+            return;
+        }
+
+        size = 0;
+        while (list != NIL) {
+            uint32_t next = rightOf(list);
+            attachNode(list);
+            list = next;
+        }
+    }
+
+    // Rozdzielenie wezlow miedzy drzewa target(key) bez kopiowania par
+    // (potem finishSorted() na kazdym). Drzewa docelowe musza korzystac
+    // z tej samej areny.
+    template <typename Target>
+    void distribute(Target target) {
+        dismantle([&](uint32_t index) {
+            CompactAVLTree& destination = target(static_cast<const K&>(at(index).key));
+            destination.pushNode(index);
+        });
+    }
+
+    // Wezly areny tablicy zwalnia jej wlasciciel, wszystkie naraz - chyba
+    // ze wymagaja wywolania destruktora; wlasna arena jest usuwana
+    ~CompactAVLTree() {
+        if (ownsPool) {
+            delete pool;
+        }
+        else if (pool != nullptr && !is_trivially_destructible<Node>::value) {
+            clear();
+        }
+    }
+
+    // Wstawianie pary klucz-wartosc (istniejaca wartosc jest nadpisywana)
+    // Zwraca true, jesli klucz zostal dodany.
+    bool insert(const K& key, V value) {
+        return insertNode(key, true, std::move(value));
+    }
+
+    // Wstawienie wartosci zbudowanej z args, jesli klucza nie ma
+    // w drzewie. Zwraca true, jesli klucz zostal dodany.
+    template <typename... Args>
+    bool emplace(const K& key, Args&&... args) {
+        return insertNode(key, false, std::forward<Args>(args)...);
+    }
+
+    // Usuwanie pary klucz-wartosc
+    bool remove(const K& key) {
+        return deleteNode(key);
+    }
+
+    // Wskaznik na wartosc dla klucza (nullptr gdy brak); wazny do
+    // nastepnego wstawienia do areny
+    V* find(const K& key) {
+        uint32_t index = search(key);
+        return index != NIL ? &at(index).value : nullptr;
+    }
+
+    const V* find(const K& key) const {
+        uint32_t index = search(key);
+        return index != NIL ? &at(index).value : nullptr;
+    }
+
+    // Czyszczenie drzewa
+    void clear() {
+        dismantle([&](uint32_t index) {
+            pool->deallocate(index);
+        });
+    }
+
+    // Zlecenie pobrania korzenia (operacje wsadowe tablicy)
+    void prefetchRoot() const {
+        if (root != NIL) {
+            prefetchRead(&at(root));
+        }
+    }
+
+    // Pobieranie aktualnego rozmiaru
+    int getSize() const {
+        return size;
+    }
+
+    // Wysokosc drzewa (0 - puste); sciezka zawsze w strone wyzszego poddrzewa
+    int getHeight() const {
+        int height = 0;
+        for (uint32_t index = root; index != NIL; index = balanceOf(index) < 0 ? rightOf(index) : leftOf(index)) {
+            height++;
+        }
+        return height;
+    }
+};
+
+#endif
@@ -0,0 +1,441 @@
+#ifndef CONCURRENT_AVL_HPP
+#define CONCURRENT_AVL_HPP
+
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <type_traits>
+#include <vector>
+#include "epoch.hpp"
+#include "hash_policy.hpp"
+
+using namespace std;
+
+// Wspolbiezna tablica mieszajaca z lancuchowaniem wykorzystujaca drzewa AVL,
+// nastawiona na odczyty. Wezly drzew sa niezmienne: pisarz buduje kopie
+// sciezki od korzenia do zmienianego wezla (kopiowanie sciezki, takze przy
+// rotacjach) i publikuje nowy korzen jednym zapisem atomowym. Czytelnicy
+// (get, contains) nie biora zadnych blokad - czytaja korzen i schodza po
+// drzewie, ktore juz sie nie zmieni.
+// Pisarze jednego kubelka wykluczaja sie blokada pasa kubelkow (LOCK_STRIPES
+// blokad dzielonych przez kubelki), pisarze roznych pasow dzialaja rownolegle.
+// Zmiana rozmiaru buduje nowa tablice kubelkow pod wylaczna blokada resizeLock
+// i podmienia ja atomowo; czytelnicy dalej czytaja stara, dopoki nie skoncza.
+// Zastapione wezly i stare tablice kubelkow zwalnia EpochManager, gdy zaden
+// czytelnik, ktory mogl je widziec, juz nie dziala.
+template <typename K = int, typename V = int, typename Hash = hash<K>,
+    typename Compare = less<K>, typename HashPolicy = FibonacciHash>
+class ConcurrentHashTableAVL {
+private:
+    static_assert(is_copy_constructible<V>::value, "kopiowanie sciezki wymaga kopiowalnych wartosci");
+
+    // Niezmienny wezel drzewa AVL
+    struct Node {
+        K key;
+        V value;
+        Node* left;
+        Node* right;
+        int height;
+
+        Node(const K& k, const V& v, Node* l, Node* r)
+            : key(k), value(v), left(l), right(r), height(1 + max(nodeHeight(l), nodeHeight(r))) {}
+    };
+
+    // Tablica korzeni drzew kubelkow
+    struct BucketArray {
+        int capacity;
+        HashPolicy policy;
+        atomic<Node*>* roots;
+
+        explicit BucketArray(int arrayCapacity) : capacity(arrayCapacity) {
+            roots = new atomic<Node*>[capacity];
+            for (int i = 0; i < capacity; i++) {
+                roots[i].store(nullptr, memory_order_relaxed);
+            }
+            policy.setCapacity(capacity);
+        }
+
+        ~BucketArray() {
+            delete[] roots;
+        }
+    };
+
+    // Blokada pasa kubelkow na osobnej linii pamieci
+    struct alignas(64) Stripe {
+        mutex lock;
+    };
+
+    static const int LOCK_STRIPES = 256;
+
+    mutable EpochManager epochs;
+    atomic<BucketArray*> buckets;
+    atomic<int> capacity;
+    atomic<int> size;
+    const double LOAD_FACTOR_THRESHOLD = 1.0;
+    shared_mutex resizeLock;   // wspolnie - zapisy, wylacznie - zmiana rozmiaru
+    Stripe stripes[LOCK_STRIPES];
+    Hash hasher;
+    Compare compare;
+
+    static int nodeHeight(Node* node) {
+        return node != nullptr ? node->height : 0;
+    }
+
+    // Zwolnienie calego drzewa (nikt go juz nie czyta)
+    static void destroyTree(Node* node) {
+        if (node == nullptr) {
+            return;
+        }
+        destroyTree(node->left);
+        destroyTree(node->right);
+        delete node;
+    }
+
+    // Zwolnienie tablicy kubelkow razem z drzewami (deleter dla EpochManager)
+    static void destroyArray(void* object) {
+        BucketArray* array = static_cast<BucketArray*>(object);
+        for (int i = 0; i < array->capacity; i++) {
+            destroyTree(array->roots[i].load(memory_order_relaxed));
+        }
+        delete array;
+    }
+
+    // Nowy wezel (key, value) z poddrzewami left i right, zbalansowany.
+    // Wezly rozebrane przy rotacji trafiaja do retired.
+    Node* balance(const K& key, const V& value, Node* left, Node* right, vector<Node*>& retired) {
+        int leftHeight = nodeHeight(left);
+        int rightHeight = nodeHeight(right);
+
+        if (leftHeight > rightHeight + 1) {
+            // Przypadek Lewy-Lewy - rotacja w prawo
+            if (nodeHeight(left->left) >= nodeHeight(left->right)) {
+                retired.push_back(left);
+                return new Node(left->key, left->value, left->left,
+                    new Node(key, value, left->right, right));
+            }
+
+            // Przypadek Lewy-Prawy
+            Node* middle = left->right;
+            retired.push_back(left);
+            retired.push_back(middle);
+            return new Node(middle->key, middle->value,
+                new Node(left->key, left->value, left->left, middle->left),
+                new Node(key, value, middle->right, right));
+        }
+
+        if (rightHeight > leftHeight + 1) {
+            // Przypadek Prawy-Prawy - rotacja w lewo
+            if (nodeHeight(right->right) >= nodeHeight(right->left)) {
+                retired.push_back(right);
+                return new Node(right->key, right->value,
+                    new Node(key, value, left, right->left), right->right);
+            }
+
+            // Przypadek Prawy-Lewy
+            Node* middle = right->left;
+            retired.push_back(right);
+            retired.push_back(middle);
+            return new Node(middle->key, middle->value,
+                new Node(key, value, left, middle->left),
+                new Node(right->key, right->value, middle->right, right->right));
+        }
+
+        return new Node(key, value, left, right);
+    }
+
+    // Wstawienie z kopiowaniem sciezki. Zwraca nowy korzen poddrzewa albo
+    // node, gdy nic sie nie zmienilo (klucz jest, a overwrite == false).
+    Node* insertNode(Node* node, const K& key, const V& value, bool overwrite, bool& inserted, vector<Node*>& retired) {
+        if (node == nullptr) {
+            inserted = true;
+            return new Node(key, value, nullptr, nullptr);
+        }
+
+        if (compare(key, node->key)) {
+            Node* left = insertNode(node->left, key, value, overwrite, inserted, retired);
+            if (left == node->left) {
+                return node;
+            }
+            retired.push_back(node);
+            return balance(node->key, node->value, left, node->right, retired);
+        }
+
+        if (compare(node->key, key)) {
+            Node* right = insertNode(node->right, key, value, overwrite, inserted, retired);
+            if (right == node->right) {
+                return node;
+            }
+            retired.push_back(node);
+            return balance(node->key, node->value, node->left, right, retired);
+        }
+
+        // Klucz juz istnieje
+        if (!overwrite) {
+            return node;
+        }
+        retired.push_back(node);
+        return new Node(node->key, value, node->left, node->right);
+    }
+
+    // Odlaczenie najmniejszego wezla poddrzewa (minNode) z kopiowaniem sciezki
+    Node* removeMin(Node* node, Node*& minNode, vector<Node*>& retired) {
+        retired.push_back(node);
+        if (node->left == nullptr) {
+            minNode = node;
+            return node->right;
+        }
+
+        Node* left = removeMin(node->left, minNode, retired);
+        return balance(node->key, node->value, left, node->right, retired);
+    }
+
+    // Usuniecie z kopiowaniem sciezki. Zwraca node, gdy klucza nie ma.
+    Node* removeNode(Node* node, const K& key, bool& removed, vector<Node*>& retired) {
+        if (node == nullptr) {
+            return nullptr;
+        }
+
+        if (compare(key, node->key)) {
+            Node* left = removeNode(node->left, key, removed, retired);
+            if (left == node->left) {
+                return node;
+            }
+            retired.push_back(node);
+            return balance(node->key, node->value, left, node->right, retired);
+        }
+
+        if (compare(node->key, key)) {
+            Node* right = removeNode(node->right, key, removed, retired);
+            if (right == node->right) {
+                return node;
+            }
+            retired.push_back(node);
+            return balance(node->key, node->value, node->left, right, retired);
+        }
+
+        // Wezel z kluczem do usuniecia
+        removed = true;
+        retired.push_back(node);
+        if (node->left == nullptr) {
+            return node->right;
+        }
+        if (node->right == nullptr) {
+            return node->left;
+        }
+
+        // Wezel z dwojgiem dzieci - nastepnik w porzadku inorder na jego miejsce
+        Node* successor;
+        Node* right = removeMin(node->right, successor, retired);
+        return balance(successor->key, successor->value, node->left, right, retired);
+    }
+
+    // Zmiana drzewa kubelka klucza: change(korzen, retired) zwraca nowy
+    // korzen. Zastapione wezly sa odkladane do EpochManager po zwolnieniu blokad.
+    template <typename Change>
+    void changeBucket(const K& key, Change change) {
+        vector<Node*> retired;
+
+        {
+            shared_lock<shared_mutex> resizeGuard(resizeLock);
+            // Pod blokada resizeLock tablica kubelkow sie nie zmienia
+            BucketArray* array = buckets.load(memory_order_relaxed);
+            int index = array->policy(hasher(key));
+
+            lock_guard<mutex> guard(stripes[index & (LOCK_STRIPES - 1)].lock);
+            Node* root = array->roots[index].load(memory_order_relaxed);
+            Node* newRoot = change(root, retired);
+            if (newRoot != root) {
+                array->roots[index].store(newRoot, memory_order_release);
+            }
+        }
+
+        for (size_t i = 0; i < retired.size(); i++) {
+            epochs.retire(retired[i]);
+        }
+    }
+
+    // Zbudowanie zbalansowanego drzewa z posortowanych wezlow [start, end)
+    static Node* buildTree(const vector<Node*>& nodes, int start, int end) {
+        if (start >= end) {
+            return nullptr;
+        }
+        int middle = start + (end - start) / 2;
+        return new Node(nodes[middle]->key, nodes[middle]->value,
+            buildTree(nodes, start, middle), buildTree(nodes, middle + 1, end));
+    }
+
+    // Wezly drzewa w porzadku inorder do kubelkow nowej tablicy
+    static void distribute(Node* node, const BucketArray& array, const Hash& hasher, vector<vector<Node*>>& target) {
+        if (node == nullptr) {
+            return;
+        }
+        distribute(node->left, array, hasher, target);
+        target[array.policy(hasher(node->key))].push_back(node);
+        distribute(node->right, array, hasher, target);
+    }
+
+    // Zmiana rozmiaru tablicy kubelkow (jesli nikt jej jeszcze nie zmienil)
+    void resize(int newCapacity) {
+        BucketArray* oldArray;
+
+        {
+            unique_lock<shared_mutex> resizeGuard(resizeLock);
+            oldArray = buckets.load(memory_order_relaxed);
+            if (oldArray->capacity >= newCapacity) {
+                return;
+            }
+
+            BucketArray* newArray = new BucketArray(newCapacity);
+            vector<vector<Node*>> target(newCapacity);
+            for (int i = 0; i < oldArray->capacity; i++) {
+                distribute(oldArray->roots[i].load(memory_order_relaxed), *newArray, hasher, target);
+            }
+
+            // Nowe drzewa z kopii wezlow - stare drzewa czytelnicy moga jeszcze czytac
+            for (int i = 0; i < newCapacity; i++) {
+                vector<Node*>& nodes = target[i];
+                sort(nodes.begin(), nodes.end(), [this](Node* a, Node* b) { return compare(a->key, b->key); });
+                newArray->roots[i].store(buildTree(nodes, 0, (int)nodes.size()), memory_order_relaxed);
+            }
+
+            buckets.store(newArray, memory_order_release);
+            capacity.store(newCapacity);
+        }
+
+        epochs.retire(oldArray, &ConcurrentHashTableAVL::destroyArray);
+    }
+
+    // Najmniejsza pojemnosc (potega dwojki, co najmniej 16), przy ktorej
+    // expectedSize elementow nie przekracza progu wypelnienia
+    int capacityFor(int expectedSize) const {
+        int newCapacity = 16;
+        while (expectedSize > newCapacity * LOAD_FACTOR_THRESHOLD) {
+            newCapacity *= 2;
+        }
+        return newCapacity;
+    }
+
+    // Zmiana rozmiaru, gdy wspolczynnik wypelnienia przekroczy prog
+    void resizeIfNeeded() {
+        int currentCapacity = capacity.load();
+        if ((double)size.load() / currentCapacity >= LOAD_FACTOR_THRESHOLD) {
+            resize(currentCapacity * 2);
+        }
+    }
+
+public:
+    ConcurrentHashTableAVL() : ConcurrentHashTableAVL(0) {}
+
+    // Tablica od razu dopasowana do expectedSize elementow
+    explicit ConcurrentHashTableAVL(int expectedSize) : size(0) {
+        capacity.store(capacityFor(expectedSize));
+        buckets.store(new BucketArray(capacity.load()));
+    }
+
+    ConcurrentHashTableAVL(const ConcurrentHashTableAVL&) = delete;
+    ConcurrentHashTableAVL& operator=(const ConcurrentHashTableAVL&) = delete;
+
+    // Odlozone wezly i tablice zwalnia destruktor EpochManager
+    ~ConcurrentHashTableAVL() {
+        destroyArray(buckets.load());
+    }
+
+    // Wstawianie pary klucz-wartosc (istniejaca wartosc jest nadpisywana)
+    void insert(const K& key, const V& value) {
+        bool inserted = false;
+        changeBucket(key, [&](Node* root, vector<Node*>& retired) {
+            return insertNode(root, key, value, true, inserted, retired);
+        });
+
+        if (inserted) {
+            size++;
+            resizeIfNeeded();
+        }
+    }
+
+    // Wstawienie wartosci, jesli klucza nie ma w tablicy.
+    // Zwraca true, jesli klucz zostal dodany.
+    bool emplace(const K& key, const V& value) {
+        bool inserted = false;
+        changeBucket(key, [&](Node* root, vector<Node*>& retired) {
+            return insertNode(root, key, value, false, inserted, retired);
+        });
+
+        if (inserted) {
+            size++;
+            resizeIfNeeded();
+        }
+        return inserted;
+    }
+
+    // Usuwanie pary klucz-wartosc
+    bool remove(const K& key) {
+        bool removed = false;
+        changeBucket(key, [&](Node* root, vector<Node*>& retired) {
+            return removeNode(root, key, removed, retired);
+        });
+
+        if (removed) {
+            size--;
+        }
+        return removed;
+    }
+
+    // Pobieranie kopii wartosci dla klucza - bez blokad
+    optional<V> get(const K& key) const {
+        EpochManager::Guard guard(epochs);
+
+        BucketArray* array = buckets.load(memory_order_acquire);
+        Node* node = array->roots[array->policy(hasher(key))].load(memory_order_acquire);
+
+        while (node != nullptr) {
+            if (compare(key, node->key)) {
+                node = node->left;
+            }
+            else if (compare(node->key, key)) {
+                node = node->right;
+            }
+            else {
+                return node->value;
+            }
+        }
+
+        return nullopt;
+    }
+
+    bool contains(const K& key) const {
+        return get(key).has_value();
+    }
+
+    // Dopasowanie pojemnosci tak, zeby n elementow miescilo sie bez zmiany
+    // rozmiaru. Tablica nigdy sie nie zmniejsza.
+    void reserve(int n) {
+        resize(capacityFor(n));
+    }
+
+    // Czyszczenie tablicy - czytelnicy moga dalej czytac stare drzewa
+    void clear() {
+        BucketArray* oldArray;
+
+        {
+            unique_lock<shared_mutex> resizeGuard(resizeLock);
+            oldArray = buckets.load(memory_order_relaxed);
+            buckets.store(new BucketArray(16), memory_order_release);
+            capacity.store(16);
+            size.store(0);
+        }
+
+        epochs.retire(oldArray, &ConcurrentHashTableAVL::destroyArray);
+    }
+
+    // Liczba elementow. Przy rownoczesnych zapisach - przyblizona.
+    int getSize() const {
+        return size.load();
+    }
+};
+
+#endif
@@ -0,0 +1,182 @@
+#ifndef CONCURRENT_CHAINING_HPP
+#define CONCURRENT_CHAINING_HPP
+
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include "chaining.hpp"
+#include "hash_policy.hpp"
+
+using namespace std;
+
+// Wspolbiezna tablica mieszajaca z lancuchowaniem podzielona na niezalezne
+// czesci (shardy). Kazdy shard to osobna HashTableChaining
+// z wlasna blokada czytelnikow-pisarzy (shared_mutex) i wlasna pula wezlow:
+// odczyty jednego sharda ida rownolegle, zapisy blokuja tylko ten shard,
+// a zmiana rozmiaru sharda (takze przyrostowa) nie zatrzymuje pozostalych.
+// Shard wybiera finalizator Murmur ze skrotu klucza - inne bity niz te,
+// z ktorych polityka HashPolicy liczy kubelek wewnatrz sharda.
+// Wartosci sa zwracane jako kopie, bo wskaznik do wnetrza sharda
+// przestaje byc bezpieczny po zwolnieniu blokady.
+template <typename K = int, typename V = int, typename Hash = hash<K>,
+    typename KeyEqual = equal_to<K>, typename HashPolicy = FibonacciHash>
+class ConcurrentHashTableChaining {
+private:
+    typedef HashTableChaining<K, V, Hash, KeyEqual, HashPolicy> Table;
+
+    // Shard na osobnych liniach pamieci - blokady sasiednich shardow
+    // nie wspoldziela linii (false sharing)
+    struct alignas(64) Shard {
+        mutable shared_mutex lock;
+        Table table;
+    };
+
+    unique_ptr<Shard[]> shards;
+    int shardCount;
+    Hash hasher;
+    MurmurHash shardPolicy;
+
+    // Wspolna czesc konstruktorow; incrementalMode - przyrostowa zmiana
+    // rozmiaru wewnatrz shardow
+    void init(int requestedShards, bool incrementalMode) {
+        shardCount = 1;
+        while (shardCount < requestedShards) {
+            shardCount *= 2;
+        }
+
+        shards.reset(new Shard[shardCount]);
+        if (incrementalMode) {
+            for (int i = 0; i < shardCount; i++) {
+                shards[i].table = Table::incremental();
+            }
+        }
+        shardPolicy.setCapacity(shardCount);
+    }
+
+    // Znacznik konstruktora tablicy z przyrostowa zmiana rozmiaru
+    struct IncrementalTag {};
+
+    ConcurrentHashTableChaining(int requestedShards, IncrementalTag) {
+        init(requestedShards, true);
+    }
+
+    Shard& shardFor(const K& key) {
+        return shards[shardPolicy(hasher(key))];
+    }
+
+    const Shard& shardFor(const K& key) const {
+        return shards[shardPolicy(hasher(key))];
+    }
+
+public:
+    static const int DEFAULT_SHARDS = 64;
+
+    // requestedShards - liczba shardow (zaokraglana w gore do potegi dwojki)
+    explicit ConcurrentHashTableChaining(int requestedShards = DEFAULT_SHARDS) {
+        init(requestedShards, false);
+    }
+
+    // ConcurrentHashTableChaining(true) nie moze po cichu oznaczac jednego sharda
+    template <typename T, typename = enable_if_t<is_same<T, bool>::value>>
+    explicit ConcurrentHashTableChaining(T) = delete;
+
+    // Tablica z przyrostowa zmiana rozmiaru wewnatrz shardow (nazwana funkcja
+    // zamiast parametru bool, jak HashTableChaining::incremental()).
+    // Zwracana bez kopiowania (C++17), choc blokady nie sa przenoszalne.
+    static ConcurrentHashTableChaining incremental(int requestedShards = DEFAULT_SHARDS) {
+        return ConcurrentHashTableChaining(requestedShards, IncrementalTag());
+    }
+
+    // Blokady nie sa kopiowalne ani przenoszalne
+    ConcurrentHashTableChaining(const ConcurrentHashTableChaining&) = delete;
+    ConcurrentHashTableChaining& operator=(const ConcurrentHashTableChaining&) = delete;
+
+    // Wstawianie pary klucz-wartosc (istniejaca wartosc jest nadpisywana)
+    void insert(const K& key, V value) {
+        Shard& shard = shardFor(key);
+        unique_lock<shared_mutex> guard(shard.lock);
+        shard.table.insert(key, std::move(value));
+    }
+
+    // Wstawienie wartosci zbudowanej z args, jesli klucza nie ma w tablicy.
+    // Zwraca true, jesli klucz zostal dodany.
+    template <typename... Args>
+    bool emplace(const K& key, Args&&... args) {
+        Shard& shard = shardFor(key);
+        unique_lock<shared_mutex> guard(shard.lock);
+        return shard.table.emplace(key, std::forward<Args>(args)...);
+    }
+
+    // Usuwanie pary klucz-wartosc
+    bool remove(const K& key) {
+        Shard& shard = shardFor(key);
+        unique_lock<shared_mutex> guard(shard.lock);
+        return shard.table.remove(key);
+    }
+
+    // Zmiana wartosci w miejscu: func(V&) wywolywane pod blokada sharda.
+    // Zwraca false, gdy klucza nie ma.
+    template <typename Func>
+    bool update(const K& key, Func func) {
+        Shard& shard = shardFor(key);
+        unique_lock<shared_mutex> guard(shard.lock);
+        V* value = shard.table.find(key);
+        if (value == nullptr) {
+            return false;
+        }
+        func(*value);
+        return true;
+    }
+
+    // Pobieranie kopii wartosci dla klucza
+    optional<V> get(const K& key) const {
+        const Shard& shard = shardFor(key);
+        shared_lock<shared_mutex> guard(shard.lock);
+        return shard.table.get(key);
+    }
+
+    bool contains(const K& key) const {
+        const Shard& shard = shardFor(key);
+        shared_lock<shared_mutex> guard(shard.lock);
+        return shard.table.find(key) != nullptr;
+    }
+
+    // Dopasowanie pojemnosci shardow do n elementow rozlozonych rowno
+    void reserve(int n) {
+        int perShard = n / shardCount + 1;
+        for (int i = 0; i < shardCount; i++) {
+            unique_lock<shared_mutex> guard(shards[i].lock);
+            shards[i].table.reserve(perShard);
+        }
+    }
+
+    // Czyszczenie tablicy (shard po shardzie)
+    void clear() {
+        for (int i = 0; i < shardCount; i++) {
+            unique_lock<shared_mutex> guard(shards[i].lock);
+            shards[i].table.clear();
+        }
+    }
+
+    // Suma rozmiarow shardow. Przy rownoczesnych zapisach shardy sa liczone
+    // po kolei, wiec wynik nie musi odpowiadac zadnej jednej chwili.
+    int getSize() const {
+        int size = 0;
+        for (int i = 0; i < shardCount; i++) {
+            shared_lock<shared_mutex> guard(shards[i].lock);
+            size += shards[i].table.getSize();
+        }
+        return size;
+    }
+
+    int getShardCount() const {
+        return shardCount;
+    }
+};
+
+#endif
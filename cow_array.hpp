@@ -0,0 +1,318 @@
+#ifndef COW_ARRAY_HPP
+#define COW_ARRAY_HPP
+
+#include <iostream>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// Domyslne operacje na elementach CowArray: kopia przez przypisanie,
+// zwolnienie niczego nie robi (wystarcza destruktor elementu)
+template <typename T>
+struct CowCopyOps {
+    void copy(const T& from, T& to) {
+        // Elementy niekopiowalne nigdy nie sa wspoldzielone - tablice nie
+        // udostepniaja wtedy migawek, wiec ta galaz nie jest uzywana
+        if constexpr (is_copy_assignable<T>::value) {
+            to = from;
+        }
+    }
+
+    void destroy(T&) {}
+};
+
+// Tablica o stalej dlugosci, ktora mozna wspoldzielic miedzy kopiami
+// (copy-on-write). Dopoki nikt jej nie skopiowal, elementy leza w jednym
+// bloku i dostep to zwykle indeksowanie. Pierwsza kopia dzieli blok na
+// segmenty po SEGMENT_SIZE elementow ze wspolnym katalogiem - kopia kosztuje
+// O(1). Zapis przez write() najpierw kopiuje katalog (jesli jest
+// wspoldzielony), a potem tylko segment z zapisywanym elementem. Odczyt
+// przez operator[] nigdy niczego nie kopiuje.
+// Ops mowi, jak skopiowac element do nowego segmentu (np. skopiowac liste
+// wezlow) i jak zwolnic element segmentu, ktorego nikt juz nie uzywa.
+// Liczniki odwolan nie sa atomowe: kopie moga byc czytane z innych watkow,
+// ale tworzone, zapisywane i niszczone tylko w jednym watku.
+template <typename T, typename Ops = CowCopyOps<T>>
+class CowArray {
+public:
+    static const int SEGMENT_SHIFT = 8;
+    static const int SEGMENT_SIZE = 1 << SEGMENT_SHIFT;
+
+private:
+    struct Block;
+
+    // Naglowek segmentu. Segment skopiowany przy zapisie ma elementy zaraz
+    // za naglowkiem; segment z podzialu bloku wskazuje blok.
+    struct alignas(T) alignas(void*) SegmentHeader {
+        int refs;
+        int count;
+        Block* block;     // nullptr - segment przydzielony osobno
+    };
+
+    // Blok z allocate() po podziale na segmenty - zwalniany z ostatnim z nich
+    struct Block {
+        int refs;         // zywe segmenty bloku
+        T* items;
+        vector<SegmentHeader> headers;
+    };
+
+    // Katalog segmentow wspoldzielony przez kopie tablicy
+    struct Directory {
+        int refs;
+        vector<T*> segments;
+        vector<SegmentHeader*> headers;
+    };
+
+    T* flat;              // elementy w jednym bloku; nullptr po podziale na segmenty
+    Directory* directory;
+    T* const* segments;   // directory->segments.data() - jeden odczyt mniej przy dostepie
+    int length;
+    Ops ops;
+
+    static SegmentHeader* header(T* items) {
+        return reinterpret_cast<SegmentHeader*>(items) - 1;
+    }
+
+    // Nowy osobny segment z count elementami zbudowanymi konstruktorem domyslnym
+    static T* newSegment(int count) {
+        SegmentHeader* h = static_cast<SegmentHeader*>(::operator new(sizeof(SegmentHeader) + sizeof(T) * (size_t)count));
+        h->refs = 1;
+        h->count = count;
+        h->block = nullptr;
+
+        T* items = reinterpret_cast<T*>(h + 1);
+        for (int i = 0; i < count; i++) {
+            new (&items[i]) T();
+        }
+        return items;
+    }
+
+    // Zniszczenie count elementow (runOps - razem z Ops::destroy)
+    void destroyItems(T* items, int count, bool runOps) {
+        for (int i = 0; i < count; i++) {
+            if (runOps) {
+                ops.destroy(items[i]);
+            }
+            items[i].~T();
+        }
+    }
+
+    // Porzucenie odwolania do segmentu; ostatnie odwolanie zwalnia segment
+    // (a ostatni segment bloku - caly blok)
+    void releaseSegment(T* items, SegmentHeader* h, bool runOps) {
+        if (--h->refs > 0) {
+            return;
+        }
+
+        destroyItems(items, h->count, runOps);
+        Block* block = h->block;
+        if (block == nullptr) {
+            ::operator delete(h);
+        }
+        else if (--block->refs == 0) {
+            ::operator delete(block->items);
+            delete block;
+        }
+    }
+
+    // Podzial jednego bloku na segmenty przed pierwszym wspoldzieleniem.
+    // Elementy zostaja na miejscu, zmienia sie tylko sposob dostepu.
+    void split() {
+        if (flat == nullptr) {
+            return;
+        }
+
+        int count = (length + SEGMENT_SIZE - 1) >> SEGMENT_SHIFT;
+        Block* block = new Block;
+        block->refs = count;
+        block->items = flat;
+        block->headers.resize(count);
+
+        directory = new Directory;
+        directory->refs = 1;
+        directory->segments.resize(count);
+        directory->headers.resize(count);
+        for (int k = 0; k < count; k++) {
+            SegmentHeader& h = block->headers[k];
+            h.refs = 1;
+            int start = k << SEGMENT_SHIFT;
+            h.count = length - start < SEGMENT_SIZE ? length - start : SEGMENT_SIZE;
+            h.block = block;
+            directory->segments[k] = flat + (k << SEGMENT_SHIFT);
+            directory->headers[k] = &h;
+        }
+        segments = directory->segments.data();
+        flat = nullptr;
+    }
+
+    // Wlasna kopia katalogu (segmenty dalej wspoldzielone)
+    void cloneDirectory() {
+        Directory* copy = new Directory;
+        copy->refs = 1;
+        copy->segments = directory->segments;
+        copy->headers = directory->headers;
+        for (size_t i = 0; i < copy->headers.size(); i++) {
+            copy->headers[i]->refs++;
+        }
+
+        directory->refs--;
+        directory = copy;
+        segments = copy->segments.data();
+    }
+
+    // Wlasna kopia segmentu k
+    void cloneSegment(int k) {
+        T*& items = directory->segments[k];
+        SegmentHeader*& h = directory->headers[k];
+        int count = h->count;
+        T* copy = newSegment(count);
+        for (int i = 0; i < count; i++) {
+            ops.copy(items[i], copy[i]);
+        }
+
+        releaseSegment(items, h, true);
+        items = copy;
+        h = header(copy);
+    }
+
+    // Przejecie katalogu innej tablicy (po jej podziale na segmenty)
+    void share(const CowArray& other) {
+        // Podzial nie zmienia zawartosci other, tylko sposob dostepu
+        const_cast<CowArray&>(other).split();
+        directory = other.directory;
+        segments = other.segments;
+        length = other.length;
+        ops = other.ops;
+        if (directory != nullptr) {
+            directory->refs++;
+        }
+    }
+
+    // Przejecie zawartosci innej tablicy; tamta zostaje pusta
+    void take(CowArray& other) noexcept {
+        flat = other.flat;
+        directory = other.directory;
+        segments = other.segments;
+        length = other.length;
+        ops = other.ops;
+        other.flat = nullptr;
+        other.directory = nullptr;
+        other.segments = nullptr;
+        other.length = 0;
+    }
+
+public:
+    CowArray() : flat(nullptr), directory(nullptr), segments(nullptr), length(0) {}
+
+    explicit CowArray(const Ops& elementOps) : flat(nullptr), directory(nullptr), segments(nullptr), length(0), ops(elementOps) {}
+
+    // Kopia dzieli katalog i segmenty z oryginalem
+    CowArray(const CowArray& other) : flat(nullptr), directory(nullptr), segments(nullptr), length(0) {
+        share(other);
+    }
+
+    CowArray(CowArray&& other) noexcept {
+        take(other);
+    }
+
+    CowArray& operator=(const CowArray& other) {
+        if (this != &other) {
+            release();
+            share(other);
+        }
+        return *this;
+    }
+
+    CowArray& operator=(CowArray&& other) noexcept {
+        if (this != &other) {
+            release();
+            take(other);
+        }
+        return *this;
+    }
+
+    ~CowArray() {
+        release();
+    }
+
+    // Zastapienie zawartosci n elementami zbudowanymi konstruktorem domyslnym
+    void allocate(int n) {
+        release();
+        if (n == 0) {
+            return;
+        }
+
+        flat = static_cast<T*>(::operator new(sizeof(T) * (size_t)n));
+        for (int i = 0; i < n; i++) {
+            new (&flat[i]) T();
+        }
+        length = n;
+    }
+
+    // Porzucenie zawartosci. runOps = false pomija Ops::destroy (np. gdy
+    // wlasciciel zwalnia potem cala pule wezlow naraz).
+    void release(bool runOps = true) {
+        if (flat != nullptr) {
+            destroyItems(flat, length, runOps);
+            ::operator delete(flat);
+        }
+        else if (directory != nullptr && --directory->refs == 0) {
+            for (size_t i = 0; i < directory->segments.size(); i++) {
+                releaseSegment(directory->segments[i], directory->headers[i], runOps);
+            }
+            delete directory;
+        }
+
+        flat = nullptr;
+        directory = nullptr;
+        segments = nullptr;
+        length = 0;
+    }
+
+    // Odczyt elementu
+    const T& operator[](int i) const {
+        if (flat != nullptr) {
+            return flat[i];
+        }
+        return segments[i >> SEGMENT_SHIFT][i & (SEGMENT_SIZE - 1)];
+    }
+
+    // Element do zapisu - wspoldzielony katalog i segment sa najpierw kopiowane
+    T& write(int i) {
+        if (flat != nullptr) {
+            return flat[i];
+        }
+
+        if (directory->refs > 1) {
+            cloneDirectory();
+        }
+
+        int k = i >> SEGMENT_SHIFT;
+        if (directory->headers[k]->refs > 1) {
+            cloneSegment(k);
+        }
+        return directory->segments[k][i & (SEGMENT_SIZE - 1)];
+    }
+
+    // Czy zapis elementu i wymagalby kopiowania
+    bool isShared(int i) const {
+        return flat == nullptr && (directory->refs > 1 || directory->headers[i >> SEGMENT_SHIFT]->refs > 1);
+    }
+
+    bool empty() const {
+        return flat == nullptr && directory == nullptr;
+    }
+
+    int size() const {
+        return length;
+    }
+
+    void setOps(const Ops& elementOps) {
+        ops = elementOps;
+    }
+};
+
+#endif
@@ -0,0 +1,478 @@
+#ifndef CUCKOO_TABLE_HPP
+#define CUCKOO_TABLE_HPP
+
+#include <iostream>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include "table_stats.hpp"
+
+// SSE2 jest dostepne na kazdym procesorze x86-64, dla innych platform
+// zostaje wersja skalarna
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CUCKOO_TABLE_SSE2 1
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using namespace std;
+
+// Tablica mieszajaca z kubelkowym haszowaniem kukulczym (4 miejsca w kubelku,
+// 2 funkcje skrotu). Klucz moze lezec tylko w jednym z dwoch swoich kubelkow,
+// wiec wyszukiwanie zawsze sprawdza najwyzej dwa kubelki - dwie linie pamieci,
+// kazda jedna instrukcja SSE2 - niezaleznie od wypelnienia tablicy.
+// Wstawianie do dwoch pelnych kubelkow szuka wszerz (BFS) najkrotszej sciezki
+// przesuniec do wolnego miejsca; gdy jej nie ma, klucz trafia do malego
+// schowka (przegladanego tylko, gdy nie jest pusty), a gdy i ten jest pelny,
+// tablica jest powiekszana.
+class HashTableCuckoo {
+private:
+    static const int SLOTS = 4;                // miejsca w kubelku
+    static const int EMPTY_KEY = INT_MIN;      // wartownik wolnego miejsca
+    static const int STASH_SIZE = 8;
+    static const int MAX_SEARCH = 256;         // kubelki odwiedzane przez BFS przy jednym wstawieniu
+    static const int MAX_PATH = 16;            // wiecej niz glebokosc BFS przy MAX_SEARCH kubelkach
+    const double LOAD_FACTOR_THRESHOLD = 0.95;
+
+    // Kubelek zajmuje 32 bajty (polowe linii pamieci podrecznej)
+    struct alignas(32) Bucket {
+        int keys[SLOTS];
+        int values[SLOTS];
+    };
+
+    // Wezel BFS: kubelek, do ktorego przeszedlby element z miejsca slot
+    // kubelka wezla parent (-1 - jeden z dwoch kubelkow wstawianego klucza)
+    struct SearchNode {
+        int bucket;
+        int parent;
+        int slot;
+    };
+
+    Bucket* buckets;
+    int bucketCount;    // potega dwojki
+    int mask;
+    int size;           // elementy w kubelkach i w schowku (bez klucza-wartownika)
+
+    // Schowek na klucze, dla ktorych nie znalazlo sie miejsca w kubelkach
+    int stashKeys[STASH_SIZE];
+    int stashValues[STASH_SIZE];
+    int stashSize;
+
+    // Klucz rowny wartownikowi jest przechowywany poza tablica
+    bool hasEmptyKey;
+    int emptyKeyValue;
+
+    // Skrot 64-bitowy (finalizator splitmix64); polowki wyznaczaja dwa kubelki
+    static unsigned long long hash(int key) {
+        unsigned long long h = (unsigned int)key;
+        h *= 0x9E3779B97F4A7C15ull;
+        h ^= h >> 29;
+        h *= 0xBF58476D1CE4E5B9ull;
+        h ^= h >> 32;
+        return h;
+    }
+
+    // Dwa rozne kubelki klucza
+    void bucketsOf(int key, int& first, int& second) const {
+        unsigned long long h = hash(key);
+        first = (int)(unsigned int)h & mask;
+        second = (int)(unsigned int)(h >> 32) & mask;
+        if (second == first) {
+            second = first ^ 1;
+        }
+    }
+
+    // Drugi kubelek klucza lezacego w kubelku bucket
+    int alternate(int key, int bucket) const {
+        int first;
+        int second;
+        bucketsOf(key, first, second);
+        return bucket == first ? second : first;
+    }
+
+    // Indeks najmlodszego ustawionego bitu maski
+    static int lowestBit(unsigned int bits) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, bits);
+        return (int)index;
+#else
+        return __builtin_ctz(bits);
+#endif
+    }
+
+    // Maska miejsc kubelka, ktorych klucz jest rowny key
+    static unsigned int matchKey(const Bucket& bucket, int key) {
+#ifdef CUCKOO_TABLE_SSE2
+        __m128i keys = _mm_load_si128((const __m128i*)bucket.keys);
+        return (unsigned int)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(keys, _mm_set1_epi32(key))));
+#else
+        unsigned int bits = 0;
+        for (int i = 0; i < SLOTS; i++) {
+            if (bucket.keys[i] == key) {
+                bits |= 1u << i;
+            }
+        }
+        return bits;
+#endif
+    }
+
+    // Wolne miejsce kubelka (-1 gdy pelny)
+    int emptySlot(int bucket) const {
+        unsigned int bits = matchKey(buckets[bucket], EMPTY_KEY);
+        return bits != 0 ? lowestBit(bits) : -1;
+    }
+
+    // Przydzielenie pustych kubelkow (schowek tez jest pusty)
+    void allocate(int newBucketCount) {
+        bucketCount = newBucketCount;
+        mask = bucketCount - 1;
+        buckets = new Bucket[bucketCount];
+        for (int i = 0; i < bucketCount; i++) {
+            for (int j = 0; j < SLOTS; j++) {
+                buckets[i].keys[j] = EMPTY_KEY;
+            }
+        }
+        stashSize = 0;
+    }
+
+    // Skopiowanie zawartosci innej tablicy (kubelki musza byc juz zwolnione)
+    void copyFrom(const HashTableCuckoo& other) {
+        bucketCount = other.bucketCount;
+        mask = other.mask;
+        size = other.size;
+        buckets = new Bucket[bucketCount];
+        memcpy(buckets, other.buckets, bucketCount * sizeof(Bucket));
+
+        stashSize = other.stashSize;
+        memcpy(stashKeys, other.stashKeys, sizeof(stashKeys));
+        memcpy(stashValues, other.stashValues, sizeof(stashValues));
+
+        hasEmptyKey = other.hasEmptyKey;
+        emptyKeyValue = other.emptyKeyValue;
+    }
+
+    // Wskaznik na wartosc klucza (nie wartownika) albo nullptr
+    int* findValue(int key) {
+        int first;
+        int second;
+        bucketsOf(key, first, second);
+
+        // Oba kubelki sa porownywane przed rozgalezieniem, wiec ich
+        // pobieranie z pamieci sie naklada
+        unsigned int firstMatch = matchKey(buckets[first], key);
+        unsigned int secondMatch = matchKey(buckets[second], key);
+        if (firstMatch != 0) {
+            return &buckets[first].values[lowestBit(firstMatch)];
+        }
+        if (secondMatch != 0) {
+            return &buckets[second].values[lowestBit(secondMatch)];
+        }
+
+        for (int i = 0; i < stashSize; i++) {
+            if (stashKeys[i] == key) {
+                return &stashValues[i];
+            }
+        }
+        return nullptr;
+    }
+
+    // Czy kubelki na sciezce BFS konczacej sie w wezle node sa rozne
+    // (przesuniecia wzdluz sciezki z powtorzonym kubelkiem moglyby nadpisac
+    // element, ktory juz sie przesunal)
+    static bool distinctPath(const SearchNode* nodes, int node) {
+        int path[MAX_PATH];
+        int length = 0;
+        for (; node >= 0; node = nodes[node].parent) {
+            for (int i = 0; i < length; i++) {
+                if (path[i] == nodes[node].bucket) {
+                    return false;
+                }
+            }
+            path[length++] = nodes[node].bucket;
+        }
+        return true;
+    }
+
+    // Wstawienie klucza do pelnych kubelkow first i second: BFS po kubelkach,
+    // do ktorych moga przejsc ich elementy, az do kubelka z wolnym miejscem,
+    // a potem przesuniecie elementow wzdluz znalezionej sciezki od jej konca.
+    // Zwraca false, gdy w MAX_SEARCH kubelkach nie ma wolnego miejsca.
+    bool insertByPath(int key, int value, int first, int second) {
+        SearchNode nodes[MAX_SEARCH];
+        nodes[0] = { first, -1, -1 };
+        nodes[1] = { second, -1, -1 };
+        int head = 0;
+        int tail = 2;
+
+        while (head < tail) {
+            int current = head++;
+            const Bucket& bucket = buckets[nodes[current].bucket];
+
+            for (int slot = 0; slot < SLOTS && tail < MAX_SEARCH; slot++) {
+                nodes[tail] = { alternate(bucket.keys[slot], nodes[current].bucket), current, slot };
+                int freeSlot = emptySlot(nodes[tail].bucket);
+
+                if (freeSlot >= 0 && distinctPath(nodes, tail)) {
+                    // Kazdy element przechodzi na miejsce zwolnione przez poprzedni
+                    int node = tail;
+                    while (nodes[node].parent >= 0) {
+                        Bucket& from = buckets[nodes[nodes[node].parent].bucket];
+                        Bucket& to = buckets[nodes[node].bucket];
+                        int moved = nodes[node].slot;
+                        to.keys[freeSlot] = from.keys[moved];
+                        to.values[freeSlot] = from.values[moved];
+                        freeSlot = moved;
+                        node = nodes[node].parent;
+                    }
+
+                    buckets[nodes[node].bucket].keys[freeSlot] = key;
+                    buckets[nodes[node].bucket].values[freeSlot] = value;
+                    return true;
+                }
+                tail++;
+            }
+        }
+        return false;
+    }
+
+    // Umieszczenie klucza, ktorego nie ma w tablicy. Zwraca false, gdy nie
+    // ma miejsca ani w kubelkach, ani w schowku.
+    bool place(int key, int value) {
+        int first;
+        int second;
+        bucketsOf(key, first, second);
+
+        int bucket = first;
+        int slot = emptySlot(first);
+        if (slot < 0) {
+            bucket = second;
+            slot = emptySlot(second);
+        }
+        if (slot >= 0) {
+            buckets[bucket].keys[slot] = key;
+            buckets[bucket].values[slot] = value;
+            return true;
+        }
+
+        if (insertByPath(key, value, first, second)) {
+            return true;
+        }
+
+        if (stashSize < STASH_SIZE) {
+            stashKeys[stashSize] = key;
+            stashValues[stashSize] = value;
+            stashSize++;
+            return true;
+        }
+        return false;
+    }
+
+    // Przeniesienie wszystkich elementow do nowych kubelkow (co najmniej
+    // newBucketCount; wiecej, jesli elementy sie nie zmieszcza)
+    void rehash(int newBucketCount) {
+        Bucket* oldBuckets = buckets;
+        int oldBucketCount = bucketCount;
+        int oldStashKeys[STASH_SIZE];
+        int oldStashValues[STASH_SIZE];
+        int oldStashSize = stashSize;
+        memcpy(oldStashKeys, stashKeys, sizeof(stashKeys));
+        memcpy(oldStashValues, stashValues, sizeof(stashValues));
+
+        while (true) {
+            allocate(newBucketCount);
+            bool placed = true;
+
+            for (int i = 0; i < oldBucketCount && placed; i++) {
+                for (int j = 0; j < SLOTS && placed; j++) {
+                    if (oldBuckets[i].keys[j] != EMPTY_KEY) {
+                        placed = place(oldBuckets[i].keys[j], oldBuckets[i].values[j]);
+                    }
+                }
+            }
+            for (int i = 0; i < oldStashSize && placed; i++) {
+                placed = place(oldStashKeys[i], oldStashValues[i]);
+            }
+
+            if (placed) {
+                break;
+            }
+            delete[] buckets;
+            newBucketCount *= 2;
+        }
+
+        delete[] oldBuckets;
+    }
+
+    // Po zwolnieniu miejsca w kubelku: przeniesienie tam elementu ze
+    // schowka, ktory moze w nim lezec
+    void refillFromStash(int bucket, int slot) {
+        for (int i = 0; i < stashSize; i++) {
+            int first;
+            int second;
+            bucketsOf(stashKeys[i], first, second);
+
+            if (first == bucket || second == bucket) {
+                buckets[bucket].keys[slot] = stashKeys[i];
+                buckets[bucket].values[slot] = stashValues[i];
+                stashSize--;
+                stashKeys[i] = stashKeys[stashSize];
+                stashValues[i] = stashValues[stashSize];
+                return;
+            }
+        }
+    }
+
+public:
+    HashTableCuckoo() {
+        allocate(4);
+        size = 0;
+        hasEmptyKey = false;
+        emptyKeyValue = 0;
+    }
+
+    // Konstruktor kopiujacy
+    HashTableCuckoo(const HashTableCuckoo& other) {
+        copyFrom(other);
+    }
+
+    // Operator przypisania
+    HashTableCuckoo& operator=(const HashTableCuckoo& other) {
+        if (this != &other) {
+            delete[] buckets;
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    ~HashTableCuckoo() {
+        delete[] buckets;
+    }
+
+    // Wstawianie pary klucz-wartosc
+    void insert(int key, int value) {
+        if (key == EMPTY_KEY) {
+            hasEmptyKey = true;
+            emptyKeyValue = value;
+            return;
+        }
+
+        // Jesli klucz juz istnieje, aktualizuj wartosc
+        int* existing = findValue(key);
+        if (existing != nullptr) {
+            *existing = value;
+            return;
+        }
+
+        // Sprawdzenie czy potrzebna jest zmiana rozmiaru
+        if (size + 1 > bucketCount * SLOTS * LOAD_FACTOR_THRESHOLD) {
+            rehash(bucketCount * 2);
+        }
+
+        // Brak miejsca nawet w schowku - tablica rosnie az do skutku
+        while (!place(key, value)) {
+            rehash(bucketCount * 2);
+        }
+        size++;
+    }
+
+    // Usuwanie pary klucz-wartosc
+    bool remove(int key) {
+        if (key == EMPTY_KEY) {
+            bool present = hasEmptyKey;
+            hasEmptyKey = false;
+            return present;
+        }
+
+        int first;
+        int second;
+        bucketsOf(key, first, second);
+
+        int bucket = first;
+        unsigned int match = matchKey(buckets[first], key);
+        if (match == 0) {
+            bucket = second;
+            match = matchKey(buckets[second], key);
+        }
+
+        if (match != 0) {
+            int slot = lowestBit(match);
+            buckets[bucket].keys[slot] = EMPTY_KEY;
+            size--;
+            if (stashSize > 0) {
+                refillFromStash(bucket, slot);
+            }
+            return true;
+        }
+
+        for (int i = 0; i < stashSize; i++) {
+            if (stashKeys[i] == key) {
+                stashSize--;
+                stashKeys[i] = stashKeys[stashSize];
+                stashValues[i] = stashValues[stashSize];
+                size--;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Pobieranie wartosci dla klucza
+    int get(int key) {
+        if (key == EMPTY_KEY) {
+            return hasEmptyKey ? emptyKeyValue : -1;
+        }
+
+        int* value = findValue(key);
+        if (value == nullptr) {
+            return -1;
+        }
+        return *value;
+    }
+
+    // Czyszczenie tablicy mieszajacej
+    void clear() {
+        delete[] buckets;
+        allocate(4);
+        size = 0;
+        hasEmptyKey = false;
+    }
+
+    // Pobieranie aktualnego rozmiaru
+    int getSize() {
+        return size + (hasEmptyKey ? 1 : 0);
+    }
+
+    // Pamiec zajmowana przez tablice (w bajtach)
+    long long getMemoryUsage() {
+        return (long long)sizeof(*this) + (long long)bucketCount * sizeof(Bucket);
+    }
+
+    // Statystyki struktury: probeLengths - kubelki sprawdzane do znalezienia
+    // elementu (1 - pierwszy, 2 - drugi, 3 - element w schowku)
+    TableStats getStats() const {
+        TableStats stats;
+        stats.size = size + (hasEmptyKey ? 1 : 0);
+        stats.capacity = bucketCount * SLOTS;
+
+        for (int i = 0; i < bucketCount; i++) {
+            for (int j = 0; j < SLOTS; j++) {
+                if (buckets[i].keys[j] != EMPTY_KEY) {
+                    int first;
+                    int second;
+                    bucketsOf(buckets[i].keys[j], first, second);
+                    stats.probeLengths.add(i == first ? 1 : 2);
+                }
+            }
+        }
+        if (stashSize > 0) {
+            stats.probeLengths.add(3, stashSize);
+        }
+        return stats;
+    }
+};
+
+#endif
@@ -0,0 +1,205 @@
+#ifndef EPOCH_HPP
+#define EPOCH_HPP
+
+#include <iostream>
+#include <atomic>
+#include <vector>
+#include <thread>
+
+using namespace std;
+
+// Odzyskiwanie pamieci oparte na epokach (EBR) dla struktur czytanych bez
+// blokad. Czytelnik otwiera Guard na czas operacji - watek ogloszony jako
+// aktywny w biezacej epoce. Pisarz, ktory odlaczyl obiekt od struktury,
+// przekazuje go do retire() zamiast go zwalniac; obiekt odlozony w epoce e
+// jest zwalniany, gdy globalna epoka dojdzie do e + 2 - wtedy zaden
+// czytelnik, ktory mogl go widziec, juz nie dziala.
+// Globalna epoka rosnie tylko, gdy wszystkie aktywne watki ja oglosily.
+// Kazdy watek ma wlasny rekord (liste odlozonych obiektow), wiec retire()
+// nie wymaga synchronizacji. Rekordy zyja do zniszczenia menedzera
+// (watek o tym samym identyfikatorze przejmuje rekord zakonczonego watku),
+// a obiekty odlozone przez watek, ktory przestal pisac, sa zwalniane
+// najpozniej w destruktorze menedzera.
+// Watek pamieta rekordy kilku ostatnio uzywanych menedzerow w malej
+// pamieci podrecznej o stalym rozmiarze; identyfikatory menedzerow sie nie
+// powtarzaja, wiec wpis zniszczonego menedzera juz nigdy nie pasuje i jest
+// po prostu nadpisywany.
+class EpochManager {
+private:
+    // Obiekt czekajacy na zwolnienie
+    struct Retired {
+        void* object;
+        void (*deleter)(void*);
+        unsigned long long epoch;
+    };
+
+    // Rekord watku na osobnej linii pamieci
+    struct alignas(64) Record {
+        atomic<unsigned long long> state;   // (epoka << 1) | 1 - aktywny, 0 - poza operacja
+        vector<Retired> limbo;
+        thread::id owner;                   // watek, do ktorego nalezy rekord
+        Record* next;
+
+        explicit Record(thread::id recordOwner) : state(0), owner(recordOwner), next(nullptr) {}
+    };
+
+    // Wpis pamieci podrecznej watku: identyfikator menedzera -> rekord watku
+    struct CacheEntry {
+        unsigned long long id;
+        Record* record;
+    };
+
+    // Liczba odlozonych obiektow, po ktorej watek probuje je zwolnic
+    static const int RECLAIM_THRESHOLD = 128;
+    // Wpisy pamieci podrecznej watku (potega dwojki)
+    static const int CACHE_ENTRIES = 4;
+
+    atomic<unsigned long long> globalEpoch;
+    atomic<Record*> records;              // lista rekordow (tylko dopisywanie)
+    unsigned long long id;                // rozroznia menedzery w pamieci podrecznej watku
+
+    static unsigned long long nextId() {
+        static atomic<unsigned long long> counter(0);
+        return ++counter;
+    }
+
+    // Pamiec podreczna watku, adresowana identyfikatorem menedzera
+    // (identyfikatory zaczynaja sie od 1, wiec zerowe wpisy sa puste)
+    static CacheEntry* threadCache() {
+        static thread_local CacheEntry cache[CACHE_ENTRIES] = {};
+        return cache;
+    }
+
+    // Rekord biezacego watku (tworzony przy pierwszym uzyciu)
+    Record* localRecord() {
+        CacheEntry& entry = threadCache()[id & (CACHE_ENTRIES - 1)];
+        if (entry.id == id) {
+            return entry.record;
+        }
+
+        // Rekord watku moze juz byc na liscie (wpis zostal nadpisany)
+        thread::id self = this_thread::get_id();
+        Record* record = records.load();
+        while (record != nullptr && record->owner != self) {
+            record = record->next;
+        }
+
+        if (record == nullptr) {
+            record = new Record(self);
+            Record* head = records.load();
+            do {
+                record->next = head;
+            } while (!records.compare_exchange_weak(head, record));
+        }
+
+        entry.id = id;
+        entry.record = record;
+        return record;
+    }
+
+    // Przesuniecie globalnej epoki, jesli wszystkie aktywne watki ja oglosily
+    void tryAdvance() {
+        // Odlaczenia obiektow przez ten watek musza byc widoczne przed odczytem rekordow
+        atomic_thread_fence(memory_order_seq_cst);
+
+        unsigned long long epoch = globalEpoch.load();
+        for (Record* r = records.load(); r != nullptr; r = r->next) {
+            unsigned long long state = r->state.load();
+            if ((state & 1) != 0 && (state >> 1) != epoch) {
+                return;
+            }
+        }
+        globalEpoch.compare_exchange_strong(epoch, epoch + 1);
+    }
+
+    // Zwolnienie obiektow rekordu odlozonych co najmniej dwie epoki temu
+    void reclaim(Record* record) {
+        unsigned long long epoch = globalEpoch.load();
+        size_t freed = 0;
+
+        // Obiekty sa dopisywane w kolejnosci epok
+        while (freed < record->limbo.size() && record->limbo[freed].epoch + 2 <= epoch) {
+            record->limbo[freed].deleter(record->limbo[freed].object);
+            freed++;
+        }
+        record->limbo.erase(record->limbo.begin(), record->limbo.begin() + freed);
+    }
+
+    template <typename T>
+    static void deleteObject(void* object) {
+        delete static_cast<T*>(object);
+    }
+
+public:
+    // Ochrona odczytu - obiekty widoczne w trakcie zycia Guard nie zostana
+    // zwolnione. Guard nie moze byc zagniezdzony w innym Guard tego samego
+    // menedzera: destruktor wewnetrznego oglosilby watek jako nieaktywny,
+    // zanim skonczy sie zewnetrzny.
+    class Guard {
+    private:
+        Record* record;
+
+    public:
+        explicit Guard(EpochManager& manager) : record(manager.localRecord()) {
+            record->state.store((manager.globalEpoch.load() << 1) | 1, memory_order_relaxed);
+            // Ogloszenie musi byc widoczne przed odczytami struktury
+            atomic_thread_fence(memory_order_seq_cst);
+        }
+
+        ~Guard() {
+            record->state.store(0, memory_order_release);
+        }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+    };
+
+    EpochManager() : globalEpoch(0), records(nullptr), id(nextId()) {}
+
+    EpochManager(const EpochManager&) = delete;
+    EpochManager& operator=(const EpochManager&) = delete;
+
+    // Zwolnienie wszystkich odlozonych obiektow - zadne operacje juz nie trwaja
+    ~EpochManager() {
+        Record* record = records.load();
+        while (record != nullptr) {
+            for (size_t i = 0; i < record->limbo.size(); i++) {
+                record->limbo[i].deleter(record->limbo[i].object);
+            }
+            Record* next = record->next;
+            delete record;
+            record = next;
+        }
+    }
+
+    // Odlozenie obiektu odlaczonego od struktury; deleter(object) zostanie
+    // wywolany, gdy nikt go juz nie czyta. Nie wolno wywolywac pod Guard.
+    void retire(void* object, void (*deleter)(void*)) {
+        Record* record = localRecord();
+        Retired retired = { object, deleter, globalEpoch.load() };
+        record->limbo.push_back(retired);
+
+        if ((int)record->limbo.size() >= RECLAIM_THRESHOLD) {
+            tryAdvance();
+            reclaim(record);
+        }
+    }
+
+    template <typename T>
+    void retire(T* object) {
+        retire(object, &EpochManager::deleteObject<T>);
+    }
+
+    // Proba przesuniecia epoki i zwolnienia obiektow odlozonych przez
+    // biezacy watek bez czekania na RECLAIM_THRESHOLD - dla rzadko
+    // odkladanych, duzych obiektow. Nie wolno wywolywac pod Guard.
+    void collect() {
+        Record* record = localRecord();
+        if (!record->limbo.empty()) {
+            tryAdvance();
+            reclaim(record);
+        }
+    }
+};
+
+#endif
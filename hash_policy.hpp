@@ -0,0 +1,84 @@
+#ifndef HASH_POLICY_HPP
+#define HASH_POLICY_HPP
+
+#include <iostream>
+#include <cstddef>
+
+using namespace std;
+
+// Polityki mieszania wspolne dla tablic HashTableOpenAddressing,
+// HashTableChaining i HashTableAVL. Polityka dostaje pojemnosc tablicy
+// (zawsze potege dwojki) przez setCapacity(), a operator() zamienia skrot
+// klucza (wynik funktora Hash tablicy, np. hash<int>) na indeks z przedzialu
+// [0, capacity).
+
+// Dawna funkcja skrot % capacity - zostawiona do porownan
+struct ModuloHash {
+    size_t capacity;
+
+    ModuloHash() : capacity(1) {}
+
+    void setCapacity(int newCapacity) {
+        capacity = (size_t)newCapacity;
+    }
+
+    int operator()(size_t h) const {
+        return (int)(h % capacity);
+    }
+
+    static const char* name() {
+        return "Modulo";
+    }
+};
+
+// Mieszanie Fibonacciego (multiplikatywne): mnozenie przez 2^64 / phi
+// i wziecie gornych bitow - bez dzielenia, dobrze rozrzuca kolejne klucze
+struct FibonacciHash {
+    int shift;
+
+    FibonacciHash() : shift(64) {}
+
+    void setCapacity(int newCapacity) {
+        shift = 64;
+        for (int c = newCapacity; c > 1; c >>= 1) {
+            shift--;
+        }
+    }
+
+    int operator()(size_t h) const {
+        unsigned long long product = (unsigned long long)h * 11400714819323198485ull;
+        // Przesuniecie o 64 bity jest niezdefiniowane, a pojemnosc 1 daje zawsze 0
+        return shift >= 64 ? 0 : (int)(product >> shift);
+    }
+
+    static const char* name() {
+        return "Fibonacci";
+    }
+};
+
+// Finalizator MurmurHash3 (fmix64) i maska potegi dwojki
+struct MurmurHash {
+    unsigned long long mask;
+
+    MurmurHash() : mask(0) {}
+
+    void setCapacity(int newCapacity) {
+        mask = (unsigned long long)newCapacity - 1;
+    }
+
+    int operator()(size_t key) const {
+        unsigned long long h = (unsigned long long)key;
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ull;
+        h ^= h >> 33;
+        return (int)(h & mask);
+    }
+
+    static const char* name() {
+        return "Murmur";
+    }
+};
+
+#endif
@@ -0,0 +1,561 @@
+#ifndef HYBRID_HPP
+#define HYBRID_HPP
+
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include "avl_tree.hpp"
+#include "hash_policy.hpp"
+#include "node_pool.hpp"
+#include "table_stats.hpp"
+
+using namespace std;
+
+// Tablica mieszajaca z kubelkami hybrydowymi (jak HashMap w Javie 8).
+// Kubelek jest zwykle krotka lista powiazana, a lista dluzsza niz
+// treeifyThreshold zamienia sie w drzewo AVL. Drzewo, ktore skurczy sie do
+// polowy progu, wraca do listy - odstep miedzy progami chroni przed ciaglym
+// przelaczaniem przy wstawieniach i usunieciach na granicy.
+// Typowe obciazenie idzie wiec sciezka zwyklego lancuchowania, a klucze
+// celowo kolidujace kosztuja O(log n) w kubelku zamiast O(n).
+// Tablica, z ktorej przeniesiono zawartosc, nie ma kubelkow ani pul
+// (pojemnosc 0) - dostaje je przy pierwszym wstawieniu.
+// K, V - typy klucza i wartosci
+// Hash, KeyEqual - funkcja skrotu i porownanie kluczy w listach
+// Compare - porzadek kluczy w drzewach
+// HashPolicy - polityka mieszania z hash_policy.hpp
+template <typename K = int, typename V = int, typename Hash = hash<K>,
+    typename KeyEqual = equal_to<K>, typename Compare = less<K>, typename HashPolicy = FibonacciHash>
+class HashTableHybrid {
+public:
+    // Domyslna dlugosc listy, powyzej ktorej kubelek staje sie drzewem
+    static const int DEFAULT_TREEIFY_THRESHOLD = 8;
+
+private:
+    // Struktura wezla dla listy powiazanej
+    struct Node {
+        K key;
+        V value;
+        Node* next;
+
+        template <typename... Args>
+        Node(const K& k, Args&&... args) : key(k), value(std::forward<Args>(args)...), next(nullptr) {}
+    };
+
+    typedef NodePool<Node> Pool;
+    typedef AVLTree<K, V, Compare> Tree;
+    typedef typename Tree::Pool TreePool;
+
+    // Kubelek: lista (tree == nullptr) albo drzewo (chain == nullptr)
+    struct Bucket {
+        Node* chain;
+        Tree* tree;
+
+        Bucket() : chain(nullptr), tree(nullptr) {}
+    };
+
+    unique_ptr<Pool> pool;               // wezly list
+    unique_ptr<TreePool> treePool;       // wezly drzew
+    vector<Bucket> table;
+    int capacity;
+    int size;
+    int treeifyThreshold;
+    const double LOAD_FACTOR_THRESHOLD = 1.0;
+    Hash hasher;
+    KeyEqual keyEqual;
+    HashPolicy policy;
+
+#ifdef HASH_TABLE_STATS
+    ResizeCounters counters;
+#endif
+
+    // Indeks kubelka dla klucza
+    int hash(const K& key) const {
+        return policy(hasher(key));
+    }
+
+    // Drzewo, ktore ma co najwyzej tyle elementow, wraca do listy
+    int untreeifyThreshold() const {
+        return treeifyThreshold / 2;
+    }
+
+    // Nowe puste drzewo korzystajace z puli wezlow drzew
+    Tree* newTree() {
+        Tree* tree = new Tree();
+        tree->setPool(treePool.get());
+        return tree;
+    }
+
+    // Wyszukanie wezla z kluczem w liscie o podanej glowie
+    Node* findInList(Node* current, const K& key) const {
+        while (current != nullptr) {
+            if (keyEqual(current->key, key)) {
+                return current;
+            }
+            current = current->next;
+        }
+
+        return nullptr;
+    }
+
+    // Zamiana listy kubelka w drzewo
+    void treeify(Bucket& bucket) {
+        Tree* tree = newTree();
+        Node* current = bucket.chain;
+        while (current != nullptr) {
+            Node* next = current->next;
+            tree->insert(current->key, std::move(current->value));
+            pool->deallocate(current);
+            current = next;
+        }
+
+        bucket.chain = nullptr;
+        bucket.tree = tree;
+    }
+
+    // Zamiana drzewa kubelka z powrotem w liste
+    void untreeify(Bucket& bucket) {
+        bucket.tree->drain([&](K&& key, V&& value) {
+            Node* node = pool->allocate(key, std::move(value));
+            node->next = bucket.chain;
+            bucket.chain = node;
+        });
+
+        delete bucket.tree;
+        bucket.tree = nullptr;
+    }
+
+    // Porzucenie wszystkich kubelkow. Wezly z trywialnym destruktorem
+    // (np. int -> int) sa zwalniane naraz z pulami, bez przechodzenia list.
+    void destroyNodes() {
+        bool trivial = is_trivially_destructible<K>::value && is_trivially_destructible<V>::value;
+
+        for (Bucket& bucket : table) {
+            if (bucket.tree != nullptr) {
+                delete bucket.tree;   // drzewo na puli zwalnia wezly tylko, gdy maja destruktor
+            }
+            else if (!trivial) {
+                while (bucket.chain != nullptr) {
+                    Node* next = bucket.chain->next;
+                    pool->deallocate(bucket.chain);
+                    bucket.chain = next;
+                }
+            }
+        }
+        table.clear();
+
+        if (trivial && pool != nullptr) {
+            pool->releaseAll();
+            treePool->releaseAll();
+        }
+    }
+
+    // Najmniejsza pojemnosc (potega dwojki, co najmniej 16), przy ktorej
+    // expectedSize elementow nie przekracza progu wypelnienia
+    int capacityFor(int expectedSize) const {
+        int newCapacity = 16;
+        while (expectedSize > newCapacity * LOAD_FACTOR_THRESHOLD) {
+            newCapacity *= 2;
+        }
+        return newCapacity;
+    }
+
+    // Zmiana rozmiaru tablicy gdy wspolczynnik wypelnienia przekroczy prog
+    // (albo na zadanie reserve). Wezly list sa przepinane, a drzewa
+    // rozdzielane (AVLTree::distribute) na drzewa nowych kubelkow budowane
+    // w czasie liniowym; drzewo, ktore po podziale jest male, wraca do listy.
+    void resize(int newCapacity) {
+#ifdef HASH_TABLE_STATS
+        counters.resizes++;
+        RehashTimer timer(counters);
+#endif
+
+        vector<Bucket> oldTable = std::move(table);
+
+        capacity = newCapacity;
+        table.assign(capacity, Bucket());
+        policy.setCapacity(capacity);
+
+        vector<int> treeIndices;   // kubelki, ktore dostaly wezly drzew
+        for (Bucket& old : oldTable) {
+            Node* current = old.chain;
+            while (current != nullptr) {
+                Node* next = current->next;
+                Bucket& bucket = table[hash(current->key)];
+                current->next = bucket.chain;
+                bucket.chain = current;
+                current = next;
+            }
+
+            if (old.tree != nullptr) {
+                old.tree->distribute([&](const K& key) -> Tree& {
+                    int index = hash(key);
+                    if (table[index].tree == nullptr) {
+                        table[index].tree = newTree();
+                        treeIndices.push_back(index);
+                    }
+                    return *table[index].tree;
+                });
+                delete old.tree;
+            }
+        }
+
+        for (int index : treeIndices) {
+            Bucket& bucket = table[index];
+            bucket.tree->finishSorted();
+
+            // Przy podwajaniu kubelek dostaje wezly z jednego starego kubelka;
+            // gdyby trafily tu tez wezly listy, dolaczaja do drzewa
+            while (bucket.chain != nullptr) {
+                Node* next = bucket.chain->next;
+                bucket.tree->insert(bucket.chain->key, std::move(bucket.chain->value));
+                pool->deallocate(bucket.chain);
+                bucket.chain = next;
+            }
+
+            if (bucket.tree->getSize() <= untreeifyThreshold()) {
+                untreeify(bucket);
+            }
+        }
+    }
+
+    // Wspolna czesc insert i emplace; Overwrite - czy nadpisac istniejaca wartosc.
+    // Zwraca true, jesli klucz zostal dodany.
+    template <bool Overwrite, typename... Args>
+    bool insertImpl(const K& key, Args&&... args) {
+        // Sprawdzenie czy potrzebna jest zmiana rozmiaru
+        // (przy pojemnosci 0 warunek jest zawsze spelniony)
+        if (size >= capacity * LOAD_FACTOR_THRESHOLD) {
+            if (capacity == 0) {
+                init(16, treeifyThreshold);
+            }
+            else {
+                resize(capacity * 2);
+            }
+        }
+
+        return insertUnchecked<Overwrite>(key, std::forward<Args>(args)...);
+    }
+
+    // Wstawienie bez sprawdzania progu wypelnienia
+    template <bool Overwrite, typename... Args>
+    bool insertUnchecked(const K& key, Args&&... args) {
+        Bucket& bucket = table[hash(key)];
+
+        if (bucket.tree != nullptr) {
+            bool inserted;
+            if constexpr (Overwrite) {
+                inserted = bucket.tree->insert(key, V(std::forward<Args>(args)...));
+            }
+            else {
+                inserted = bucket.tree->emplace(key, std::forward<Args>(args)...);
+            }
+            if (inserted) {
+                size++;
+            }
+            return inserted;
+        }
+
+        // Sprawdzenie czy klucz juz istnieje (i przy okazji dlugosci listy)
+        int length = 0;
+        for (Node* current = bucket.chain; current != nullptr; current = current->next) {
+            if (keyEqual(current->key, key)) {
+                if constexpr (Overwrite) {
+                    current->value = V(std::forward<Args>(args)...);
+                }
+                return false;
+            }
+            length++;
+        }
+
+        // Dodanie nowego wezla na poczatek listy
+        Node* newNode = pool->allocate(key, std::forward<Args>(args)...);
+        newNode->next = bucket.chain;
+        bucket.chain = newNode;
+        size++;
+
+        if (length + 1 > treeifyThreshold) {
+            treeify(bucket);
+        }
+        return true;
+    }
+
+    // Wspolna czesc konstruktorow
+    void init(int initialCapacity, int threshold) {
+        pool = make_unique<Pool>();
+        treePool = make_unique<TreePool>();
+        treeifyThreshold = max(1, threshold);
+        capacity = initialCapacity;
+        size = 0;
+        table.assign(capacity, Bucket());
+        policy.setCapacity(capacity);
+    }
+
+    // Skopiowanie zawartosci innej tablicy; kopia dostaje wlasne pule wezlow
+    void copyFrom(const HashTableHybrid& other) {
+        init(other.capacity, other.treeifyThreshold);
+        size = other.size;
+        hasher = other.hasher;
+        keyEqual = other.keyEqual;
+        policy = other.policy;
+
+        for (int i = 0; i < capacity; i++) {
+            const Bucket& from = other.table[i];
+            Bucket& to = table[i];
+
+            if (from.tree != nullptr) {
+                // Pary przychodza posortowane - drzewo budowane w czasie liniowym
+                to.tree = newTree();
+                from.tree->forEach([&](const K& key, const V& value) {
+                    to.tree->pushSorted(key, value);
+                });
+                to.tree->finishSorted();
+                continue;
+            }
+
+            // Kopia listy w tej samej kolejnosci
+            Node** link = &to.chain;
+            for (Node* current = from.chain; current != nullptr; current = current->next) {
+                *link = pool->allocate(current->key, current->value);
+                link = &(*link)->next;
+            }
+        }
+    }
+
+    // Przejecie zawartosci innej tablicy; tamta zostaje pusta, bez kubelkow
+    // i pul (bez przydzialu pamieci - dostanie je przy pierwszym wstawieniu)
+    void moveFrom(HashTableHybrid& other) noexcept {
+        pool = std::move(other.pool);
+        treePool = std::move(other.treePool);
+        table = std::move(other.table);
+        capacity = other.capacity;
+        size = other.size;
+        treeifyThreshold = other.treeifyThreshold;
+        hasher = std::move(other.hasher);
+        keyEqual = std::move(other.keyEqual);
+        policy = other.policy;
+
+        other.table.clear();
+        other.capacity = 0;
+        other.size = 0;
+    }
+
+public:
+    HashTableHybrid() {
+        init(16, DEFAULT_TREEIFY_THRESHOLD);
+    }
+
+    // Tablica od razu dopasowana do expectedSize elementow; treeifyThreshold -
+    // dlugosc listy, powyzej ktorej kubelek staje sie drzewem
+    explicit HashTableHybrid(int expectedSize, int treeifyThreshold = DEFAULT_TREEIFY_THRESHOLD) {
+        init(capacityFor(expectedSize), treeifyThreshold);
+    }
+
+    // Konstruktor kopiujacy
+    HashTableHybrid(const HashTableHybrid& other) {
+        copyFrom(other);
+    }
+
+    // Konstruktor przenoszacy
+    HashTableHybrid(HashTableHybrid&& other) noexcept {
+        moveFrom(other);
+    }
+
+    // Operator przypisania
+    HashTableHybrid& operator=(const HashTableHybrid& other) {
+        if (this != &other) {
+            destroyNodes();
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    // Przenoszacy operator przypisania
+    HashTableHybrid& operator=(HashTableHybrid&& other) noexcept {
+        if (this != &other) {
+            destroyNodes();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    // Pamiec wezlow zwalniaja pule
+    ~HashTableHybrid() {
+        destroyNodes();
+    }
+
+    // Wstawianie pary klucz-wartosc (istniejaca wartosc jest nadpisywana)
+    void insert(const K& key, V value) {
+        insertImpl<true>(key, std::move(value));
+    }
+
+    // Wstawienie wartosci zbudowanej w miejscu z args, jesli klucza nie ma
+    // w tablicy. Zwraca true, jesli klucz zostal dodany.
+    template <typename... Args>
+    bool emplace(const K& key, Args&&... args) {
+        return insertImpl<false>(key, std::forward<Args>(args)...);
+    }
+
+    // Usuwanie pary klucz-wartosc
+    bool remove(const K& key) {
+        if (capacity == 0) {
+            return false;
+        }
+
+        Bucket& bucket = table[hash(key)];
+
+        if (bucket.tree != nullptr) {
+            if (!bucket.tree->remove(key)) {
+                return false;
+            }
+
+            size--;
+            if (bucket.tree->getSize() <= untreeifyThreshold()) {
+                untreeify(bucket);
+            }
+            return true;
+        }
+
+        Node** link = &bucket.chain;
+        while (*link != nullptr) {
+            Node* current = *link;
+            if (keyEqual(current->key, key)) {
+                *link = current->next;
+                pool->deallocate(current);
+                size--;
+                return true;
+            }
+            link = &current->next;
+        }
+
+        return false;
+    }
+
+    // Wskaznik na wartosc dla klucza (nullptr gdy brak)
+    V* find(const K& key) {
+        if (capacity == 0) {
+            return nullptr;
+        }
+
+        Bucket& bucket = table[hash(key)];
+        if (bucket.tree != nullptr) {
+            return bucket.tree->find(key);
+        }
+
+        Node* node = findInList(bucket.chain, key);
+        return node != nullptr ? &node->value : nullptr;
+    }
+
+    const V* find(const K& key) const {
+        if (capacity == 0) {
+            return nullptr;
+        }
+
+        const Bucket& bucket = table[hash(key)];
+        if (bucket.tree != nullptr) {
+            return bucket.tree->find(key);
+        }
+
+        Node* node = findInList(bucket.chain, key);
+        return node != nullptr ? &node->value : nullptr;
+    }
+
+    // Pobieranie kopii wartosci dla klucza
+    optional<V> get(const K& key) const {
+        const V* value = find(key);
+        if (value == nullptr) {
+            return nullopt;
+        }
+        return *value;
+    }
+
+    // Dopasowanie pojemnosci tak, zeby n elementow miescilo sie bez zmiany
+    // rozmiaru. Tablica nigdy sie nie zmniejsza.
+    void reserve(int n) {
+        if (capacity == 0) {
+            init(capacityFor(n), treeifyThreshold);
+            return;
+        }
+
+        int newCapacity = capacityFor(n);
+        if (newCapacity > capacity) {
+            resize(newCapacity);
+        }
+    }
+
+    // Wstawienie count par (keys[i], values[i]) z jednorazowym dopasowaniem
+    // pojemnosci - bez sprawdzania progu przy kazdym wstawieniu
+    void build(const K* keys, const V* values, int count) {
+        reserve(size + count);
+
+        for (int i = 0; i < count; i++) {
+            insertUnchecked<true>(keys[i], values[i]);
+        }
+    }
+
+    // Czyszczenie tablicy mieszajacej
+    void clear() {
+        if (pool == nullptr) {
+            init(16, treeifyThreshold);
+            return;
+        }
+
+        destroyNodes();
+
+        capacity = 16;
+        size = 0;
+        table.assign(capacity, Bucket());
+        policy.setCapacity(capacity);
+    }
+
+    // Pobieranie aktualnego rozmiaru
+    int getSize() const {
+        return size;
+    }
+
+    // Pojemnosc tablicy (liczba kubelkow)
+    int getCapacity() const {
+        return capacity;
+    }
+
+    // Dlugosc listy, powyzej ktorej kubelek staje sie drzewem
+    int getTreeifyThreshold() const {
+        return treeifyThreshold;
+    }
+
+    // Statystyki struktury: dlugosci list w kubelkach-listach (razem
+    // z pustymi) oraz wysokosci i rozmiary drzew w kubelkach zamienionych
+    // na drzewa (treeSizes.total() - liczba takich kubelkow)
+    TableStats getStats() const {
+        TableStats stats;
+        stats.size = size;
+        stats.capacity = capacity;
+        stats.nodeBytes = pool != nullptr ? pool->getStats().bytes + treePool->getStats().bytes : 0;
+
+        for (const Bucket& bucket : table) {
+            if (bucket.tree != nullptr) {
+                stats.treeHeights.add(bucket.tree->getHeight());
+                stats.treeSizes.add(bucket.tree->getSize());
+                continue;
+            }
+
+            int length = 0;
+            for (Node* current = bucket.chain; current != nullptr; current = current->next) {
+                length++;
+            }
+            stats.chainLengths.add(length);
+        }
+
+#ifdef HASH_TABLE_STATS
+        counters.fill(stats);
+#endif
+        return stats;
+    }
+};
+
+#endif
@@ -0,0 +1,494 @@
+#ifndef LOCK_FREE_OPEN_ADDRESSING_HPP
+#define LOCK_FREE_OPEN_ADDRESSING_HPP
+
+#include <iostream>
+#include <atomic>
+#include <functional>
+#include <optional>
+#include "hash_policy.hpp"
+#include "epoch.hpp"
+
+using namespace std;
+
+// Tablica mieszajaca z adresowaniem otwartym (sondowanie liniowe) bez blokad,
+// dla kluczy i wartosci int. Wszystkie operacje mozna wywolywac rownolegle
+// z wielu watkow (poza clear()); zaden watek nie czeka na inny.
+//
+// Kazde miejsce ma dwa slowa atomowe:
+// - slowo klucza: EMPTY_KEY -> klucz (zajecie przez CAS) i tak juz zostaje;
+//   miejsce puste w chwili migracji dostaje DEAD_KEY (grob w slowie klucza),
+//   zeby nikt juz go nie zajal w starej tablicy,
+// - slowo wartosci: EMPTY_VALUE (jeszcze nic), wartosc, TOMBSTONE (usuniety),
+//   FROZEN | wartosc (kopiowana do nowej tablicy), MOVED (skopiowana - szukaj
+//   w nastepnej tablicy) albo MOVED_EMPTY (nic do kopiowania).
+// Wartosci sa publikowane przez CAS slowa wartosci; klucz raz zapisany
+// w miejscu sie nie zmienia, wiec ponowne wstawienie usunietego klucza
+// uzywa jego starego miejsca. Groby licza sie do zapelnienia (used).
+//
+// Zmiana rozmiaru dokleja nastepna tablice (next) i przenosi miejsca po
+// jednym: zamrozenie wartosci, skopiowanie jej do nastepnej tablicy,
+// oznaczenie MOVED. Kazdy watek, ktory trafi na migrowana tablice, pomaga -
+// przenosi porcje miejsc i dokancza przenoszenie miejsca, ktorego
+// potrzebuje - zamiast czekac. Groby nie sa kopiowane. Po przeniesieniu
+// wszystkich miejsc nastepna tablica staje sie glowna.
+// Kazda operacja dziala pod EpochManager::Guard. Tablice, za ktore
+// przesunela sie glowna tablica, sa odcinane od poczatku lancucha (oldest)
+// i odkladane do EpochManager - zwalnia je, gdy zaden watek, ktory mogl
+// je widziec, juz nie dziala. Przy ciaglym wstawianiu i usuwaniu kazda
+// migracja tworzy tablice tej samej wielkosci, wiec bez tego stare
+// tablice gromadzilyby sie bez ograniczenia.
+template <typename Hash = hash<int>, typename HashPolicy = FibonacciHash>
+class LockFreeHashTableOpenAddressing {
+private:
+    // Slowo klucza - klucz int albo jedna z wartosci spoza zakresu int
+    static const long long EMPTY_KEY = 1LL << 32;
+    static const long long DEAD_KEY = 1LL << 33;
+
+    // Slowo wartosci - wartosc int zapisana jako unsigned (bity 0-31) albo stan
+    static const long long FROZEN = 1LL << 32;
+    static const long long EMPTY_VALUE = 1LL << 33;
+    static const long long TOMBSTONE = 1LL << 34;
+    static const long long MOVED = 1LL << 35;
+    static const long long MOVED_EMPTY = 1LL << 36;
+
+    static const int MIN_CAPACITY = 1024;
+    static const int COPY_CHUNK = 256;   // miejsca przenoszone przez jednego pomocnika naraz
+
+    struct Slot {
+        atomic<long long> key;
+        atomic<long long> value;
+    };
+
+    struct Table {
+        Slot* slots;
+        int capacity;
+        HashPolicy policy;
+        atomic<int> used;                // zajete slowa kluczy (z grobami)
+        atomic<Table*> next;             // nastepna tablica w trakcie migracji
+        atomic<unsigned int> copyIndex;  // poczatek nastepnej porcji do przeniesienia
+        atomic<int> copied;              // przeniesione miejsca
+
+        explicit Table(int tableCapacity)
+            : capacity(tableCapacity), used(0), next(nullptr), copyIndex(0), copied(0) {
+            slots = new Slot[capacity];
+            for (int i = 0; i < capacity; i++) {
+                slots[i].key.store(EMPTY_KEY, memory_order_relaxed);
+                slots[i].value.store(EMPTY_VALUE, memory_order_relaxed);
+            }
+            policy.setCapacity(capacity);
+        }
+
+        ~Table() {
+            delete[] slots;
+        }
+    };
+
+    // Rodzaj zapisu w writeSlot
+    enum WriteMode {
+        WRITE_INSERT,    // wstawienie albo nadpisanie
+        WRITE_EMPLACE,   // wstawienie tylko gdy klucza nie ma
+        WRITE_REMOVE,    // usuniecie
+        WRITE_COPY       // kopia z migracji - tylko do miejsca bez wartosci
+    };
+
+    atomic<Table*> head;     // glowna tablica
+    atomic<Table*> oldest;   // pierwsza jeszcze nieodlozona tablica lancucha next
+    atomic<int> size;
+    Hash hasher;
+    mutable EpochManager epochs;
+
+    static long long encode(int value) {
+        return (long long)(unsigned int)value;
+    }
+
+    static int decode(long long word) {
+        return (int)(unsigned int)(word & 0xffffffffLL);
+    }
+
+    // Czy slowo wartosci to zwykla (niezamrozona) wartosc
+    static bool isValue(long long word) {
+        return word < FROZEN;
+    }
+
+    // Miejsce klucza w tablicy t. claim - zajecie pierwszego pustego miejsca,
+    // gdy klucza nie ma (claimed = true). nullptr - klucza nie ma (i nie zostal dodany).
+    Slot* findSlot(Table* t, int key, bool claim, bool& claimed) {
+        long long keyWord = key;
+        int mask = t->capacity - 1;
+        int index = t->policy(hasher(key));
+
+        for (int i = 0; i < t->capacity; i++) {
+            Slot& slot = t->slots[(index + i) & mask];
+            long long current = slot.key.load();
+
+            if (current == EMPTY_KEY) {
+                if (!claim) {
+                    return nullptr;
+                }
+                if (slot.key.compare_exchange_strong(current, keyWord)) {
+                    t->used++;
+                    claimed = true;
+                    return &slot;
+                }
+                // current to teraz klucz, ktory zajal miejsce przed nami
+            }
+
+            if (current == keyWord) {
+                return &slot;
+            }
+        }
+
+        // Cala tablica zajeta przez inne klucze
+        return nullptr;
+    }
+
+    // Doklejenie nastepnej tablicy do t (jesli jeszcze jej nie ma).
+    // Nowa tablica miesci zywe elementy przy zapelnieniu 1/4 - groby nie
+    // sa kopiowane, wiec tablica pelna grobow nie rosnie (albo sie zmniejsza).
+    Table* startResize(Table* t) {
+        Table* next = t->next.load();
+        if (next != nullptr) {
+            return next;
+        }
+
+        int newCapacity = MIN_CAPACITY;
+        long long live = size.load();
+        while ((long long)newCapacity < live * 4) {
+            newCapacity *= 2;
+        }
+
+        Table* created = new Table(newCapacity);
+        if (!t->next.compare_exchange_strong(next, created)) {
+            // Inny watek dokleil tablice pierwszy
+            delete created;
+            return next;
+        }
+        return created;
+    }
+
+    // Przeniesienie jednego miejsca tablicy t do t->next
+    void copySlot(Table* t, Slot& slot) {
+        // Puste miejsce nie moze juz zostac zajete w starej tablicy
+        long long keyWord = slot.key.load();
+        while (keyWord == EMPTY_KEY && !slot.key.compare_exchange_weak(keyWord, DEAD_KEY)) {
+        }
+
+        long long word = slot.value.load();
+        while (true) {
+            if (word == MOVED || word == MOVED_EMPTY) {
+                return;
+            }
+
+            if (word == EMPTY_VALUE || word == TOMBSTONE) {
+                // Nic do kopiowania
+                long long moved = word == EMPTY_VALUE ? MOVED_EMPTY : MOVED;
+                if (slot.value.compare_exchange_strong(word, moved)) {
+                    finishSlot(t);
+                    return;
+                }
+                continue;
+            }
+
+            if (isValue(word)) {
+                // Zamrozenie - od teraz wartosc w tej tablicy sie nie zmieni
+                if (!slot.value.compare_exchange_strong(word, word | FROZEN)) {
+                    continue;
+                }
+                word |= FROZEN;
+            }
+
+            // Zamrozona wartosc do nastepnej tablicy, potem MOVED
+            writeSlot(t->next.load(), (int)keyWord, word & ~FROZEN, WRITE_COPY);
+            if (slot.value.compare_exchange_strong(word, MOVED)) {
+                finishSlot(t);
+            }
+            return;
+        }
+    }
+
+    // Policzenie przeniesionego miejsca; ostatnie konczy migracje t
+    void finishSlot(Table* t) {
+        if (t->copied.fetch_add(1) + 1 == t->capacity) {
+            promote();
+        }
+    }
+
+    // Przesuniecie glownej tablicy za wszystkie tablice, ktorych migracja
+    // sie skonczyla (t moze skonczyc sie przed swoja poprzedniczka)
+    void promote() {
+        Table* current = head.load();
+        while (current->copied.load() == current->capacity) {
+            if (head.compare_exchange_strong(current, current->next.load())) {
+                current = current->next.load();
+            }
+        }
+    }
+
+    // Pomoc w migracji t - przeniesienie kolejnej porcji miejsc. Porcje sa
+    // brane cyklicznie, wiec gdy watek, ktory wzial porcje, sie zatrzyma,
+    // inne watki przejda po niej ponownie i dokoncza migracje.
+    void helpCopy(Table* t) {
+        if (t->copied.load() >= t->capacity) {
+            return;
+        }
+
+        // Pojemnosc jest wielokrotnoscia COPY_CHUNK, wiec porcja sie nie zawija
+        int start = (int)(t->copyIndex.fetch_add(COPY_CHUNK) & (unsigned int)(t->capacity - 1));
+        for (int i = start; i < start + COPY_CHUNK; i++) {
+            copySlot(t, t->slots[i]);
+        }
+    }
+
+    // Zapis klucza zaczynajac od tablicy t. Zwraca true, jesli zapis zmienil
+    // obecnosc klucza (wstawienie nowego albo usuniecie istniejacego).
+    bool writeSlot(Table* t, int key, long long newWord, WriteMode mode) {
+        while (true) {
+            bool claimed = false;
+            Slot* slot = findSlot(t, key, mode != WRITE_REMOVE, claimed);
+
+            if (slot == nullptr) {
+                Table* next = t->next.load();
+                if (mode == WRITE_REMOVE && next == nullptr) {
+                    return false;
+                }
+                // Brak miejsca - klucz nigdy nie trafi do tej tablicy
+                if (next == nullptr) {
+                    next = startResize(t);
+                }
+                helpCopy(t);
+                t = next;
+                continue;
+            }
+
+            if (claimed && t->used.load() >= t->capacity / 2) {
+                startResize(t);
+            }
+
+            // Podczas migracji zapisy ida do nastepnej tablicy, po
+            // przeniesieniu miejsca klucza. Kopia moze trafic do migrowanej
+            // tablicy - zostanie przeniesiona dalej razem z miejscem.
+            Table* next = t->next.load();
+            if (next != nullptr && mode != WRITE_COPY) {
+                copySlot(t, *slot);
+                helpCopy(t);
+                t = next;
+                continue;
+            }
+
+            long long word = slot->value.load();
+            while (true) {
+                if (word == MOVED_EMPTY) {
+                    // Klucz nigdy tu nie mial wartosci - szukamy dalej
+                    break;
+                }
+
+                if (mode == WRITE_COPY) {
+                    // Miejsce z wartoscia (albo jego dalsze kopie) jest nowsze od kopii
+                    if (word != EMPTY_VALUE) {
+                        return false;
+                    }
+                    if (slot->value.compare_exchange_strong(word, newWord)) {
+                        return false;
+                    }
+                    continue;
+                }
+
+                if (!isValue(word) && word != EMPTY_VALUE && word != TOMBSTONE) {
+                    // FROZEN albo MOVED - dokonczenie przenoszenia i dalej
+                    break;
+                }
+
+                bool present = isValue(word);
+                if (mode == WRITE_EMPLACE && present) {
+                    return false;
+                }
+                if (mode == WRITE_REMOVE && !present) {
+                    return false;
+                }
+
+                if (slot->value.compare_exchange_strong(word, newWord)) {
+                    if (mode == WRITE_REMOVE) {
+                        size--;
+                        return true;
+                    }
+                    if (!present) {
+                        size++;
+                    }
+                    return !present;
+                }
+            }
+
+            // Migracja tego miejsca - zapis w nastepnej tablicy
+            if (word != MOVED_EMPTY) {
+                copySlot(t, *slot);
+            }
+            t = t->next.load();
+        }
+    }
+
+    // Odlozenie do EpochManager tablic sprzed glownej - ich migracja sie
+    // skonczyla, a nowe operacje zaczynaja od glownej. Wywolywane po
+    // zapisie, poza Guard.
+    void retireTables() {
+        if (oldest.load() == head.load()) {
+            return;
+        }
+
+        bool retired = false;
+        while (true) {
+            Table* t;
+            {
+                EpochManager::Guard guard(epochs);
+                t = oldest.load();
+                if (t == head.load()) {
+                    break;
+                }
+                // Tablica sprzed glownej zawsze ma nastepna
+                if (!oldest.compare_exchange_strong(t, t->next.load())) {
+                    continue;
+                }
+            }
+            epochs.retire(t);
+            retired = true;
+        }
+
+        // Tablice sa duze i odkladane rzadko - bez czekania na prog
+        if (retired) {
+            epochs.collect();
+        }
+    }
+
+    // Zwolnienie wszystkich nieodlozonych tablic lancucha
+    void destroyTables() {
+        Table* t = oldest.load();
+        while (t != nullptr) {
+            Table* next = t->next.load();
+            delete t;
+            t = next;
+        }
+        oldest.store(nullptr);
+    }
+
+public:
+    LockFreeHashTableOpenAddressing() : size(0) {
+        Table* first = new Table(MIN_CAPACITY);
+        oldest.store(first);
+        head.store(first);
+    }
+
+    // Tablica od razu dopasowana do expectedSize elementow
+    explicit LockFreeHashTableOpenAddressing(int expectedSize) : size(0) {
+        int capacity = MIN_CAPACITY;
+        while (capacity < expectedSize * 2) {
+            capacity *= 2;
+        }
+        Table* first = new Table(capacity);
+        oldest.store(first);
+        head.store(first);
+    }
+
+    LockFreeHashTableOpenAddressing(const LockFreeHashTableOpenAddressing&) = delete;
+    LockFreeHashTableOpenAddressing& operator=(const LockFreeHashTableOpenAddressing&) = delete;
+
+    ~LockFreeHashTableOpenAddressing() {
+        destroyTables();
+    }
+
+    // Wstawianie pary klucz-wartosc (istniejaca wartosc jest nadpisywana)
+    void insert(int key, int value) {
+        {
+            EpochManager::Guard guard(epochs);
+            writeSlot(head.load(), key, encode(value), WRITE_INSERT);
+        }
+        retireTables();
+    }
+
+    // Wstawienie wartosci, jesli klucza nie ma w tablicy.
+    // Zwraca true, jesli klucz zostal dodany.
+    bool emplace(int key, int value) {
+        bool added;
+        {
+            EpochManager::Guard guard(epochs);
+            added = writeSlot(head.load(), key, encode(value), WRITE_EMPLACE);
+        }
+        retireTables();
+        return added;
+    }
+
+    // Usuwanie pary klucz-wartosc
+    bool remove(int key) {
+        bool removed;
+        {
+            EpochManager::Guard guard(epochs);
+            removed = writeSlot(head.load(), key, TOMBSTONE, WRITE_REMOVE);
+        }
+        retireTables();
+        return removed;
+    }
+
+    // Pobieranie wartosci dla klucza. Tylko odczyty - bez CAS i bez pomocy
+    // w migracji, wiec wyszukiwania skaluja sie z liczba rdzeni.
+    optional<int> get(int key) const {
+        EpochManager::Guard guard(epochs);
+        Table* t = head.load(memory_order_acquire);
+        long long keyWord = key;
+
+        while (t != nullptr) {
+            int mask = t->capacity - 1;
+            int index = t->policy(hasher(key));
+
+            for (int i = 0; i < t->capacity; i++) {
+                const Slot& slot = t->slots[(index + i) & mask];
+                long long current = slot.key.load(memory_order_acquire);
+
+                if (current == EMPTY_KEY) {
+                    break;
+                }
+
+                if (current == keyWord) {
+                    long long word = slot.value.load(memory_order_acquire);
+                    if (word == MOVED || word == MOVED_EMPTY) {
+                        break;
+                    }
+                    if (word == EMPTY_VALUE || word == TOMBSTONE) {
+                        return nullopt;
+                    }
+                    // Zwykla albo zamrozona wartosc - obie sa aktualne
+                    return decode(word);
+                }
+            }
+
+            // Klucza nie ma w tej tablicy - moze byc w nastepnej
+            t = t->next.load(memory_order_acquire);
+        }
+
+        return nullopt;
+    }
+
+    bool contains(int key) const {
+        return get(key).has_value();
+    }
+
+    // Liczba elementow. Przy rownoczesnych zapisach - przyblizona.
+    int getSize() const {
+        return size.load();
+    }
+
+    // Pojemnosc glownej tablicy
+    int getCapacity() const {
+        EpochManager::Guard guard(epochs);
+        return head.load()->capacity;
+    }
+
+    // Czyszczenie tablicy (i zwolnienie starych tablic). Nie moze byc
+    // wywolywane rownolegle z innymi operacjami.
+    void clear() {
+        destroyTables();
+        Table* first = new Table(MIN_CAPACITY);
+        oldest.store(first);
+        head.store(first);
+        size.store(0);
+    }
+};
+
+#endif
@@ -1,6 +1,5 @@
 #include <iostream>
 #include <cstdlib>
-#include <ctime>
 #include <chrono>
 #include <iomanip>
 #include <fstream>
@@ -8,12 +7,18 @@
 #include <string>
 #include "open_addressing.hpp"
 #include "chaining.hpp"
+#include "swiss_table.hpp"
+#include "workload.hpp"
 
 using namespace std;
 
+// Generator danych; zestaw d uzywa ziarna DATA_SEED + d
+const unsigned long long DATA_SEED = 12345;
+FastRandom generator(DATA_SEED);
+
 // Losowa liczba
 int randomInt(int min, int max) {
-    return min + rand() % (max - min + 1);
+    return generator.nextInt(min, max);
 }
 
 // Test wydajnosci
@@ -33,8 +38,8 @@ void testPerformance() {
     
     // Plik wynikow
     ofstream outFile("wyniki.xlsx");
-    outFile << "Rozmiar\tAdresowanie otwarte Wstawianie (ns)\tLancuchowanie Wstawianie (ns)\t"
-            << "Adresowanie otwarte Usuwanie (ns)\tLancuchowanie Usuwanie (ns)\n";
+    outFile << "Rozmiar\tAdresowanie otwarte Wstawianie (ns)\tLancuchowanie Wstawianie (ns)\tSwiss Wstawianie (ns)\t"
+            << "Adresowanie otwarte Usuwanie (ns)\tLancuchowanie Usuwanie (ns)\tSwiss Usuwanie (ns)\n";
     
     // Dla kazdego rozmiaru
     for (int s = 0; s < numSizes; s++) {
@@ -44,15 +49,17 @@ void testPerformance() {
         // Srednie czasy
         double avgOpenAddressingInsert = 0;
         double avgChainingInsert = 0;
+        double avgSwissInsert = 0;
         double avgOpenAddressingRemove = 0;
         double avgChainingRemove = 0;
+        double avgSwissRemove = 0;
         
         // Dla kazdego zestawu danych
         for (int dataSet = 0; dataSet < n; dataSet++) {
             cout << "  Zestaw danych " << dataSet + 1 << " z " << n << endl;
             
             // Generator losowy
-            srand(time(nullptr) + dataSet);
+            generator.setSeed(DATA_SEED + dataSet);
             
             // Losowe klucze i wartosci
             vector<int> keys(size);
@@ -66,8 +73,9 @@ void testPerformance() {
             // Dla kazdego powtorzenia
             for (int r = 0; r < rep; r++) {
                 // Nowe tablice
-                HashTableOpenAddressing openAddressingTable;
-                HashTableChaining chainingTable;
+                HashTableOpenAddressing<> openAddressingTable;
+                HashTableChaining<> chainingTable;
+                HashTableSwiss swissTable;
                 
                 // Test wstawiania - adresowanie otwarte
                 auto start = chrono::high_resolution_clock::now();
@@ -87,6 +95,15 @@ void testPerformance() {
                 duration = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
                 avgChainingInsert += duration / (double)size;
                 
+                // Test wstawiania - Swiss
+                start = chrono::high_resolution_clock::now();
+                for (int i = 0; i < size; i++) {
+                    swissTable.insert(keys[i], values[i]);
+                }
+                end = chrono::high_resolution_clock::now();
+                duration = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+                avgSwissInsert += duration / (double)size;
+                
                 // Test usuwania - adresowanie otwarte
                 start = chrono::high_resolution_clock::now();
                 for (int i = 0; i < size; i++) {
@@ -104,28 +121,43 @@ void testPerformance() {
                 end = chrono::high_resolution_clock::now();
                 duration = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
                 avgChainingRemove += duration / (double)size;
+                
+                // Test usuwania - Swiss
+                start = chrono::high_resolution_clock::now();
+                for (int i = 0; i < size; i++) {
+                    swissTable.remove(keys[i]);
+                }
+                end = chrono::high_resolution_clock::now();
+                duration = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+                avgSwissRemove += duration / (double)size;
             }
         }
         
         // Oblicz srednie
         avgOpenAddressingInsert /= (n * rep);
         avgChainingInsert /= (n * rep);
+        avgSwissInsert /= (n * rep);
         avgOpenAddressingRemove /= (n * rep);
         avgChainingRemove /= (n * rep);
+        avgSwissRemove /= (n * rep);
         
         // Zapisz wyniki
         outFile << size << "\t"
                 << avgOpenAddressingInsert << "\t"
                 << avgChainingInsert << "\t"
+                << avgSwissInsert << "\t"
                 << avgOpenAddressingRemove << "\t"
-                << avgChainingRemove << "\n";
+                << avgChainingRemove << "\t"
+                << avgSwissRemove << "\n";
         
         // Wyswietl wyniki
         cout << "  Wyniki dla rozmiaru " << size << ":" << endl;
         cout << "    Adresowanie otwarte Wstawianie: " << avgOpenAddressingInsert << " ns" << endl;
         cout << "    Lancuchowanie Wstawianie: " << avgChainingInsert << " ns" << endl;
+        cout << "    Swiss Wstawianie: " << avgSwissInsert << " ns" << endl;
         cout << "    Adresowanie otwarte Usuwanie: " << avgOpenAddressingRemove << " ns" << endl;
         cout << "    Lancuchowanie Usuwanie: " << avgChainingRemove << " ns" << endl;
+        cout << "    Swiss Usuwanie: " << avgSwissRemove << " ns" << endl;
     }
     
     outFile.close();
@@ -166,6 +198,7 @@ int main() {
     cout << "1. Tablica mieszajaca z adresowaniem otwartym" << endl;
     cout << "2. Tablica mieszajaca z lancuchowaniem" << endl;
     cout << "3. WIP Tablica mieszajaca z lancuchowaniem (drzewa AVL)" << endl;
+    cout << "4. Tablica mieszajaca z adresowaniem otwartym (Swiss, grupy SSE2)" << endl;
     
     mainMenu();
     
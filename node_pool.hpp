@@ -0,0 +1,157 @@
+#ifndef NODE_POOL_HPP
+#define NODE_POOL_HPP
+
+#include <iostream>
+#include <vector>
+#include <new>
+#include <utility>
+
+using namespace std;
+
+// Statystyki puli wezlow
+struct PoolStats {
+    long long slabs;         // liczba przydzielonych blokow
+    long long capacity;      // liczba miejsc na wezly we wszystkich blokach
+    long long inUse;         // liczba zajetych wezlow
+    long long freeListed;    // liczba zwolnionych wezlow czekajacych na ponowne uzycie
+    long long allocations;   // laczna liczba przydzielonych wezlow
+    long long bytes;         // pamiec zajmowana przez bloki (w bajtach)
+};
+
+// Pula (slab) wezlow jednego typu. Wezly sa wydawane kolejno z duzych,
+// ciaglych blokow pamieci, zwolnione trafiaja na liste wolnych miejsc,
+// a releaseAll() oddaje wszystkie bloki naraz.
+// releaseAll() i destruktor nie wywoluja destruktorow wezlow.
+template <typename T>
+class NodePool {
+private:
+    // Miejsce na wezel - wolne przechowuje wskaznik na nastepne wolne
+    union Cell {
+        Cell* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    static const int FIRST_SLAB_SIZE = 64;
+    static const int MAX_SLAB_SIZE = 65536;
+
+    vector<Cell*> slabs;
+    Cell* freeList;
+    Cell* slabCurrent;   // nastepne nieuzyte miejsce w ostatnim bloku
+    Cell* slabEnd;
+    int nextSlabSize;
+
+    long long capacity;
+    long long inUse;
+    long long freeListed;
+    long long allocations;
+
+    // Wezly wyrownane ponad to, co gwarantuje zwykly operator new (np. do
+    // linii pamieci podrecznej), wymagaja wyrownanego przydzialu blokow
+    static const bool OVER_ALIGNED = alignof(Cell) > __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+    static Cell* allocateSlab(size_t cells) {
+        if constexpr (OVER_ALIGNED) {
+            return static_cast<Cell*>(::operator new(sizeof(Cell) * cells, align_val_t(alignof(Cell))));
+        }
+        else {
+            return static_cast<Cell*>(::operator new(sizeof(Cell) * cells));
+        }
+    }
+
+    static void freeSlab(Cell* slab) {
+        if constexpr (OVER_ALIGNED) {
+            ::operator delete(slab, align_val_t(alignof(Cell)));
+        }
+        else {
+            ::operator delete(slab);
+        }
+    }
+
+    // Przydzielenie nowego bloku (kazdy kolejny dwa razy wiekszy)
+    void addSlab() {
+        Cell* slab = allocateSlab((size_t)nextSlabSize);
+        slabs.push_back(slab);
+        slabCurrent = slab;
+        slabEnd = slab + nextSlabSize;
+        capacity += nextSlabSize;
+
+        if (nextSlabSize < MAX_SLAB_SIZE) {
+            nextSlabSize *= 2;
+        }
+    }
+
+public:
+    NodePool() : freeList(nullptr), slabCurrent(nullptr), slabEnd(nullptr), nextSlabSize(FIRST_SLAB_SIZE),
+        capacity(0), inUse(0), freeListed(0), allocations(0) {}
+
+    // Pula nie jest kopiowana - kopia tablicy buduje wlasna
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    ~NodePool() {
+        releaseAll();
+    }
+
+    // Utworzenie wezla w pamieci z puli
+    template <typename... Args>
+    T* allocate(Args&&... args) {
+        Cell* cell;
+
+        if (freeList != nullptr) {
+            cell = freeList;
+            freeList = freeList->next;
+            freeListed--;
+        }
+        else {
+            if (slabCurrent == slabEnd) {
+                addSlab();
+            }
+            cell = slabCurrent++;
+        }
+
+        inUse++;
+        allocations++;
+        return new (cell->storage) T(std::forward<Args>(args)...);
+    }
+
+    // Zniszczenie wezla i odlozenie jego miejsca na liste wolnych
+    void deallocate(T* node) {
+        node->~T();
+
+        Cell* cell = reinterpret_cast<Cell*>(node);
+        cell->next = freeList;
+        freeList = cell;
+        freeListed++;
+        inUse--;
+    }
+
+    // Zwolnienie wszystkich blokow naraz
+    void releaseAll() {
+        for (size_t i = 0; i < slabs.size(); i++) {
+            freeSlab(slabs[i]);
+        }
+        slabs.clear();
+
+        freeList = nullptr;
+        slabCurrent = nullptr;
+        slabEnd = nullptr;
+        nextSlabSize = FIRST_SLAB_SIZE;
+        capacity = 0;
+        inUse = 0;
+        freeListed = 0;
+    }
+
+    // Pobieranie statystyk puli
+    PoolStats getStats() const {
+        PoolStats stats;
+        stats.slabs = (long long)slabs.size();
+        stats.capacity = capacity;
+        stats.inUse = inUse;
+        stats.freeListed = freeListed;
+        stats.allocations = allocations;
+        stats.bytes = capacity * (long long)sizeof(Cell);
+        return stats;
+    }
+};
+
+#endif
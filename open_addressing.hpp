@@ -2,184 +2,796 @@
 #define OPEN_ADDRESSING_HPP
 
 #include <iostream>
+#include <algorithm>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "hash_policy.hpp"
+#include "cow_array.hpp"
+#include "prefetch.hpp"
+#include "table_stats.hpp"
 
 using namespace std;
 
 // Prosta tablica mieszajaca z adresowaniem otwartym (sondowanie liniowe)
+// K, V - typy klucza i wartosci (oba musza miec konstruktor domyslny)
+// Hash, KeyEqual - funkcja skrotu i porownanie kluczy
+// HashPolicy - polityka mieszania z hash_policy.hpp
+// W trybie przyrostowym zmiana rozmiaru nie przenosi wszystkich elementow
+// naraz - stara i nowa tablica istnieja obok siebie, a kazde wstawienie
+// i usuniecie przenosi kilka miejsc starej tablicy.
+// Miejsca leza w CowArray, wiec snapshot() kosztuje O(1), a zapisy po migawce
+// kopiuja tylko segmenty, ktore zmieniaja. Tablica, z ktorej przeniesiono
+// zawartosc, nie ma miejsc (pojemnosc 0) - dostaje je przy pierwszym wstawieniu.
+template <typename K = int, typename V = int, typename Hash = hash<K>,
+    typename KeyEqual = equal_to<K>, typename HashPolicy = FibonacciHash>
 class HashTableOpenAddressing {
 private:
     // Struktura pary klucz-wartosc
     struct Pair {
-        int key;
-        int value;
+        K key;
+        V value;
         bool isOccupied;
         bool isDeleted;
 
-        Pair() : key(0), value(0), isOccupied(false), isDeleted(false) {}
+        Pair() : key(), value(), isOccupied(false), isDeleted(false) {}
     };
 
-    Pair* table;
+    CowArray<Pair> table;
     int capacity;
     int size;
+    int tombstones;                      // miejsca usuniete w biezacej tablicy - licza sie do progu
     const double LOAD_FACTOR_THRESHOLD = 0.7;
+    Hash hasher;
+    KeyEqual keyEqual;
+    HashPolicy policy;
+
+    // Przyrostowa zmiana rozmiaru
+    static const int MIGRATE_STEP = 16;  // miejsca przenoszone przy jednej operacji
+    bool incrementalResize;
+    CowArray<Pair> oldTable;             // pusta gdy migracja nie trwa
+    int oldCapacity;
+    int migrateIndex;                    // pierwsze nieprzeniesione miejsce starej tablicy
+    HashPolicy oldPolicy;
+
+#ifdef HASH_TABLE_STATS
+    ResizeCounters counters;
+#endif
 
-    // Prosta funkcja mieszajaca
-    int hash(int key) {
-        return abs(key) % capacity;
+    // Indeks docelowy klucza w biezacej tablicy
+    int hash(const K& key) const {
+        return policy(hasher(key));
     }
 
-    // Zmiana rozmiaru tablicy gdy wspolczynnik wypelnienia przekroczy prog
-    void resize() {
-        int oldCapacity = capacity;
-        Pair* oldTable = table;
+    // Wstawienie klucza, ktorego na pewno nie ma w nowej tablicy
+    void place(K&& key, V&& value) {
+        int index = hash(key);
+        int mask = capacity - 1;
 
-        capacity *= 2;
-        table = new Pair[capacity];
-        size = 0;
+        for (int i = 0; i < capacity; i++) {
+            int probeIndex = (index + i) & mask;
+            if (!table[probeIndex].isOccupied || table[probeIndex].isDeleted) {
+                if (table[probeIndex].isDeleted) {
+                    tombstones--;
+                }
+                Pair& slot = table.write(probeIndex);
+                slot.key = std::move(key);
+                slot.value = std::move(value);
+                slot.isOccupied = true;
+                slot.isDeleted = false;
+                return;
+            }
+        }
+    }
 
-        for (int i = 0; i < oldCapacity; i++) {
-            if (oldTable[i].isOccupied && !oldTable[i].isDeleted) {
-                insert(oldTable[i].key, oldTable[i].value);
+    // Rozpoczecie przyrostowej zmiany rozmiaru (newCapacity rowne capacity -
+    // przyrostowe usuniecie nagrobkow)
+    void startMigration(int newCapacity) {
+        // Poprzednia migracja musi byc zakonczona
+        if (!oldTable.empty()) {
+            finishMigration();
+        }
+
+#ifdef HASH_TABLE_STATS
+        counters.resizes++;
+        RehashTimer timer(counters);
+#endif
+
+        oldTable = std::move(table);
+        oldCapacity = capacity;
+        oldPolicy = policy;
+        migrateIndex = 0;
+
+        capacity = newCapacity;
+        tombstones = 0;
+        table.allocate(capacity);
+        policy.setCapacity(capacity);
+    }
+
+    // Przeniesienie kolejnych miejsc starej tablicy
+    void migrateStep() {
+#ifdef HASH_TABLE_STATS
+        RehashTimer timer(counters);
+#endif
+
+        int end = migrateIndex + MIGRATE_STEP;
+        if (end > oldCapacity) {
+            end = oldCapacity;
+        }
+
+        for (; migrateIndex < end; migrateIndex++) {
+            if (oldTable[migrateIndex].isOccupied && !oldTable[migrateIndex].isDeleted) {
+                Pair& slot = oldTable.write(migrateIndex);
+                place(std::move(slot.key), std::move(slot.value));
+                // Znacznik usuniecia zachowuje ciagi sondowania starej tablicy
+                slot.isDeleted = true;
             }
         }
 
-        delete[] oldTable;
+        if (migrateIndex == oldCapacity) {
+            oldTable.release();
+        }
     }
 
-public:
-    HashTableOpenAddressing() {
-        capacity = 16;
-        size = 0;
-        table = new Pair[capacity];
+    // Dokonczenie trwajacej migracji
+    void finishMigration() {
+        while (!oldTable.empty()) {
+            migrateStep();
+        }
     }
 
-    // Konstruktor kopiujcy
-    HashTableOpenAddressing(const HashTableOpenAddressing& other) {
+    // Wyszukanie klucza w biezacej tablicy (-1 gdy brak)
+    int findIndex(const K& key) const {
+        return probe(key, hash(key));
+    }
+
+    // Sondowanie od miejsca index, policzonego wczesniej przez hash(key)
+    int probe(const K& key, int index) const {
+        int mask = capacity - 1;
+        int i = 0;
+
+        while (i < capacity) {
+            int probeIndex = (index + i) & mask;
+
+            // Jesli miejsce jest puste, klucz nie istnieje
+            if (!table[probeIndex].isOccupied) {
+                return -1;
+            }
+
+            // Jesli klucz zostal znaleziony i nie jest usuniety
+            if (!table[probeIndex].isDeleted && keyEqual(table[probeIndex].key, key)) {
+                return probeIndex;
+            }
+
+            i++;
+        }
+
+        return -1;
+    }
+
+    // Wyszukanie klucza w starej tablicy w trakcie migracji (-1 gdy brak)
+    int findInOldTable(const K& key) const {
+        if (oldTable.empty()) {
+            return -1;
+        }
+
+        int index = oldPolicy(hasher(key));
+        int mask = oldCapacity - 1;
+
+        for (int i = 0; i < oldCapacity; i++) {
+            int probeIndex = (index + i) & mask;
+
+            if (!oldTable[probeIndex].isOccupied) {
+                return -1;
+            }
+
+            if (!oldTable[probeIndex].isDeleted && keyEqual(oldTable[probeIndex].key, key)) {
+                return probeIndex;
+            }
+        }
+
+        return -1;
+    }
+
+    // Skopiowanie zawartosci innej tablicy (migracja w kopii jest od razu konczona)
+    void copyFrom(const HashTableOpenAddressing& other) {
         capacity = other.capacity;
         size = other.size;
-        table = new Pair[capacity];
+        tombstones = other.tombstones;
+        table.allocate(capacity);
+        hasher = other.hasher;
+        keyEqual = other.keyEqual;
+        policy = other.policy;
+        incrementalResize = other.incrementalResize;
+        oldTable.release();
+        oldCapacity = 0;
+        migrateIndex = 0;
 
         for (int i = 0; i < capacity; i++) {
-            table[i] = other.table[i];
+            table.write(i) = other.table[i];
+        }
+
+        // Elementy, ktorych migracja jeszcze nie przeniosla
+        if (!other.oldTable.empty()) {
+            for (int i = other.migrateIndex; i < other.oldCapacity; i++) {
+                const Pair& slot = other.oldTable[i];
+                if (slot.isOccupied && !slot.isDeleted) {
+                    place(K(slot.key), V(slot.value));
+                }
+            }
         }
     }
 
-    // Operator przypisania
-    HashTableOpenAddressing& operator=(const HashTableOpenAddressing& other) {
-        if (this != &other) {
-            delete[] table;
+    // Najmniejsza pojemnosc (potega dwojki, co najmniej 16), przy ktorej
+    // expectedSize elementow nie przekracza progu wypelnienia
+    int capacityFor(int expectedSize) const {
+        int newCapacity = 16;
+        while (expectedSize > newCapacity * LOAD_FACTOR_THRESHOLD) {
+            newCapacity *= 2;
+        }
+        return newCapacity;
+    }
+
+    // Zmiana rozmiaru tablicy gdy wspolczynnik wypelnienia przekroczy prog
+    // (albo na zadanie reserve)
+    void resize(int newCapacity) {
+#ifdef HASH_TABLE_STATS
+        counters.resizes++;
+        RehashTimer timer(counters);
+#endif
+
+        int previousCapacity = capacity;
+        CowArray<Pair> previousTable = std::move(table);
 
-            capacity = other.capacity;
-            size = other.size;
-            table = new Pair[capacity];
+        capacity = newCapacity;
+        tombstones = 0;
+        table.allocate(capacity);
+        policy.setCapacity(capacity);
 
-            for (int i = 0; i < capacity; i++) {
-                table[i] = other.table[i];
+        for (int i = 0; i < previousCapacity; i++) {
+            if (previousTable[i].isOccupied && !previousTable[i].isDeleted) {
+                // Segment wspoldzielony z migawka jest najpierw kopiowany
+                Pair& slot = previousTable.write(i);
+                place(std::move(slot.key), std::move(slot.value));
             }
         }
-        return *this;
     }
 
-    ~HashTableOpenAddressing() {
-        delete[] table;
+    // Usuniecie nagrobkow bez zmiany pojemnosci i bez drugiej tablicy.
+    // Kazdy element czeka na ulozenie i trafia na pierwsze miejsce swojego
+    // ciagu sondowania, ktore nie jest jeszcze ostatecznie zajete: puste
+    // (przeniesienie) albo z innym czekajacym elementem (zamiana, po ktorej
+    // ukladany jest tamten). Miejsca ostatecznie zajete juz sie nie zmieniaja,
+    // wiec ciagi sondowania ulozonych elementow pozostaja ciagle.
+    void compact() {
+#ifdef HASH_TABLE_STATS
+        counters.resizes++;
+        RehashTimer timer(counters);
+#endif
+
+        int mask = capacity - 1;
+        vector<char> pending(capacity, 0);
+
+        // Zapis kazdego miejsca kopiuje od razu segmenty wspoldzielone z migawka
+        for (int i = 0; i < capacity; i++) {
+            Pair& slot = table.write(i);
+            if (slot.isOccupied && slot.isDeleted) {
+                slot = Pair();
+            }
+            else if (slot.isOccupied) {
+                pending[i] = 1;
+            }
+        }
+        tombstones = 0;
+
+        for (int i = 0; i < capacity; i++) {
+            while (pending[i]) {
+                int target = hash(table[i].key);
+                while (target != i && table[target].isOccupied && !pending[target]) {
+                    target = (target + 1) & mask;
+                }
+
+                if (target == i) {
+                    pending[i] = 0;
+                }
+                else if (!table[target].isOccupied) {
+                    table.write(target) = std::move(table.write(i));
+                    table.write(i) = Pair();
+                    pending[i] = 0;
+                }
+                else {
+                    swap(table.write(target), table.write(i));
+                    pending[target] = 0;
+                }
+            }
+        }
     }
 
-    // Wstawianie pary klucz-wartosc
-    void insert(int key, int value) {
-        // Sprawdzenie czy potrzebna jest zmiana rozmiaru
-        if ((double)size / capacity >= LOAD_FACTOR_THRESHOLD) {
-            resize();
+    // Przebudowa po przekroczeniu progu przez elementy i nagrobki razem.
+    // Jesli elementy zajmuja mniej niz polowe progu, przewazaja nagrobki
+    // i wystarczy je usunac przy tej samej pojemnosci; inaczej pojemnosc
+    // jest podwajana (co tez usuwa nagrobki).
+    void rehash() {
+        // Tablica po przeniesieniu zawartosci
+        if (capacity == 0) {
+            init(16, incrementalResize);
+            return;
         }
 
-        int index = hash(key);
-        int i = 0;
+        bool sameCapacity = size < capacity * LOAD_FACTOR_THRESHOLD / 2;
+        if (incrementalResize) {
+            startMigration(sameCapacity ? capacity : capacity * 2);
+        }
+        else if (sameCapacity) {
+            compact();
+        }
+        else {
+            resize(capacity * 2);
+        }
+    }
 
-        // Sondowanie liniowe
-        while (i < capacity) {
-            int probeIndex = (index + i) % capacity;
+    // Pierwszy etap operacji wsadowej dla porcji kluczy [start, end):
+    // policzenie indeksow i pobranie miejsc, od ktorych zacznie sie sondowanie
+    void prefetchSlots(const K* keys, int start, int end, int* indices) const {
+        for (int i = start; i < end; i++) {
+            indices[i - start] = hash(keys[i]);
+            prefetchRead(&table[indices[i - start]]);
+        }
+    }
 
-            // Jesli miejsce jest puste lub oznaczone jako usuniete
-            if (!table[probeIndex].isOccupied || table[probeIndex].isDeleted) {
-                table[probeIndex].key = key;
-                table[probeIndex].value = value;
-                table[probeIndex].isOccupied = true;
-                table[probeIndex].isDeleted = false;
-                size++;
-                return;
-            }
+    // Oznaczenie miejsca jako usunietego
+    void erase(Pair& slot) {
+        slot.isDeleted = true;
+        slot.value = V();
+        size--;
+    }
 
-            // Jesli klucz juz istnieje, aktualizuj wartosc
-            if (table[probeIndex].key == key && !table[probeIndex].isDeleted) {
-                table[probeIndex].value = value;
-                return;
-            }
+    // Wspolna czesc insert i emplace; Overwrite - czy nadpisac istniejaca wartosc.
+    // Zwraca true, jesli klucz zostal dodany.
+    template <bool Overwrite, typename... Args>
+    bool insertImpl(const K& key, Args&&... args) {
+        // Przeniesienie kolejnej porcji starej tablicy
+        if (!oldTable.empty()) {
+            migrateStep();
+        }
 
-            i++;
+        // Sprawdzenie czy potrzebna jest zmiana rozmiaru - nagrobki wydluzaja
+        // sondowanie tak samo jak elementy, wiec licza sie do progu
+        // (przy pojemnosci 0 warunek jest zawsze spelniony)
+        if (size + tombstones >= capacity * LOAD_FACTOR_THRESHOLD) {
+            rehash();
         }
+
+        return insertUnchecked<Overwrite>(key, std::forward<Args>(args)...);
     }
 
-    // Usuwanie pary klucz-wartosc
-    bool remove(int key) {
+    // Wstawienie bez sprawdzania progu wypelnienia (i bez kroku migracji)
+    template <bool Overwrite, typename... Args>
+    bool insertUnchecked(const K& key, Args&&... args) {
+        // W trakcie migracji klucz moze byc jeszcze w starej tablicy
+        int oldIndex = findInOldTable(key);
+        if (oldIndex != -1) {
+            if constexpr (Overwrite) {
+                oldTable.write(oldIndex).value = V(std::forward<Args>(args)...);
+            }
+            return false;
+        }
+
         int index = hash(key);
+        int mask = capacity - 1;
+        int firstDeleted = -1;
         int i = 0;
 
+        // Sondowanie liniowe - pierwsze usuniete miejsce jest zapamietywane,
+        // ale szukanie trwa dalej, zeby nie zdublowac istniejacego klucza
         while (i < capacity) {
-            int probeIndex = (index + i) % capacity;
+            int probeIndex = (index + i) & mask;
 
-            // Jesli miejsce jest puste, klucz nie istnieje
+            // Jesli miejsce jest puste, klucza nie ma w tablicy
             if (!table[probeIndex].isOccupied) {
-                return false;
+                break;
             }
 
-            // Jesli klucz zostal znaleziony i nie jest usuniety
-            if (table[probeIndex].key == key && !table[probeIndex].isDeleted) {
-                table[probeIndex].isDeleted = true;
-                size--;
-                return true;
+            if (table[probeIndex].isDeleted) {
+                if (firstDeleted == -1) {
+                    firstDeleted = probeIndex;
+                }
+            }
+            else if (keyEqual(table[probeIndex].key, key)) {
+                // Jesli klucz juz istnieje, aktualizuj wartosc
+                if constexpr (Overwrite) {
+                    table.write(probeIndex).value = V(std::forward<Args>(args)...);
+                }
+                return false;
             }
 
             i++;
         }
 
-        return false;
+        int target = firstDeleted;
+        if (target == -1) {
+            target = (index + i) & mask;
+        }
+        else {
+            tombstones--;
+        }
+
+        Pair& slot = table.write(target);
+        slot.key = key;
+        slot.value = V(std::forward<Args>(args)...);
+        slot.isOccupied = true;
+        slot.isDeleted = false;
+        size++;
+        return true;
     }
 
-    // Pobieranie wartosci dla klucza
-    int get(int key) {
-        int index = hash(key);
-        int i = 0;
+    // Wspolna czesc konstruktorow
+    void init(int initialCapacity, bool incrementalMode) {
+        incrementalResize = incrementalMode;
+        oldTable.release();
+        oldCapacity = 0;
+        migrateIndex = 0;
+        capacity = initialCapacity;
+        size = 0;
+        tombstones = 0;
+        table.allocate(capacity);
+        policy.setCapacity(capacity);
+    }
 
-        while (i < capacity) {
-            int probeIndex = (index + i) % capacity;
+    // Przejecie zawartosci innej tablicy; tamta zostaje pusta, bez miejsc
+    // (bez przydzialu pamieci - miejsca dostanie przy pierwszym wstawieniu)
+    void moveFrom(HashTableOpenAddressing& other) noexcept {
+        table = std::move(other.table);
+        capacity = other.capacity;
+        size = other.size;
+        tombstones = other.tombstones;
+        hasher = std::move(other.hasher);
+        keyEqual = std::move(other.keyEqual);
+        policy = other.policy;
+        incrementalResize = other.incrementalResize;
+        oldTable = std::move(other.oldTable);
+        oldCapacity = other.oldCapacity;
+        migrateIndex = other.migrateIndex;
+        oldPolicy = other.oldPolicy;
+
+        other.capacity = 0;
+        other.size = 0;
+        other.tombstones = 0;
+        other.oldCapacity = 0;
+        other.migrateIndex = 0;
+    }
 
-            // Jesli miejsce jest puste, klucz nie istnieje
-            if (!table[probeIndex].isOccupied) {
-                return -1;
+    // Znacznik konstruktora migawki
+    struct SnapshotTag {};
+
+    // Znacznik konstruktora tablicy z przyrostowa zmiana rozmiaru
+    struct IncrementalTag {};
+
+    HashTableOpenAddressing(int expectedSize, IncrementalTag) {
+        init(capacityFor(expectedSize), true);
+    }
+
+    // Migawka - wszystkie pola kopiowane, segmenty wspoldzielone
+    HashTableOpenAddressing(const HashTableOpenAddressing& other, SnapshotTag)
+        : table(other.table), capacity(other.capacity), size(other.size), tombstones(other.tombstones),
+        hasher(other.hasher), keyEqual(other.keyEqual), policy(other.policy),
+        incrementalResize(other.incrementalResize), oldTable(other.oldTable),
+        oldCapacity(other.oldCapacity), migrateIndex(other.migrateIndex), oldPolicy(other.oldPolicy) {}
+
+public:
+    HashTableOpenAddressing() {
+        init(16, false);
+    }
+
+    // Tablica od razu dopasowana do expectedSize elementow
+    explicit HashTableOpenAddressing(int expectedSize) {
+        init(capacityFor(expectedSize), false);
+    }
+
+    // Dawny HashTableOpenAddressing(true) nie moze po cichu oznaczac pojemnosci dla 1 elementu
+    template <typename T, typename = enable_if_t<is_same<T, bool>::value>>
+    explicit HashTableOpenAddressing(T) = delete;
+
+    // Tablica z przyrostowa zmiana rozmiaru zamiast jednorazowej
+    // (nazwana funkcja zamiast konstruktora z bool, ktory mylilby sie
+    // z konstruktorem przyjmujacym liczbe elementow)
+    static HashTableOpenAddressing incremental(int expectedSize = 0) {
+        return HashTableOpenAddressing(expectedSize, IncrementalTag());
+    }
+
+    // Konstruktor kopiujcy
+    HashTableOpenAddressing(const HashTableOpenAddressing& other) {
+        copyFrom(other);
+    }
+
+    // Konstruktor przenoszacy
+    HashTableOpenAddressing(HashTableOpenAddressing&& other) noexcept {
+        moveFrom(other);
+    }
+
+    // Operator przypisania
+    HashTableOpenAddressing& operator=(const HashTableOpenAddressing& other) {
+        if (this != &other) {
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    // Przenoszacy operator przypisania
+    HashTableOpenAddressing& operator=(HashTableOpenAddressing&& other) noexcept {
+        if (this != &other) {
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    // Migawka tablicy w czasie O(1). Migawka i oryginal dziela segmenty miejsc;
+    // pierwszy zapis do segmentu (w dowolnej z nich) kopiuje tylko ten segment.
+    // Migawke mozna czytac z innego watku, ale tworzyc i niszczyc tylko
+    // w watku, ktory zapisuje do oryginalu.
+    HashTableOpenAddressing snapshot() const {
+        static_assert(is_copy_constructible<V>::value, "snapshot() wymaga kopiowalnych wartosci");
+        return HashTableOpenAddressing(*this, SnapshotTag());
+    }
+
+    // Wstawianie pary klucz-wartosc (istniejaca wartosc jest nadpisywana)
+    void insert(const K& key, V value) {
+        insertImpl<true>(key, std::move(value));
+    }
+
+    // Wstawienie wartosci zbudowanej z args, jesli klucza nie ma w tablicy.
+    // Zwraca true, jesli klucz zostal dodany. Miejsca tablicy sa zawsze
+    // zbudowane (puste maja K() i V()), wiec wartosc nie powstaje w miejscu:
+    // jest budowana z args i przenoszona do miejsca. K i V musza miec
+    // konstruktor domyslny i przenoszace przypisanie.
+    template <typename... Args>
+    bool emplace(const K& key, Args&&... args) {
+        return insertImpl<false>(key, std::forward<Args>(args)...);
+    }
+
+    // Usuwanie pary klucz-wartosc
+    bool remove(const K& key) {
+        if (!oldTable.empty()) {
+            migrateStep();
+        }
+
+        // W trakcie migracji klucz moze byc jeszcze w starej tablicy
+        int index = findInOldTable(key);
+        if (index != -1) {
+            erase(oldTable.write(index));
+            return true;
+        }
+
+        index = findIndex(key);
+        if (index == -1) {
+            return false;
+        }
+
+        erase(table.write(index));
+        tombstones++;
+        return true;
+    }
+
+    // Wskaznik na wartosc dla klucza (nullptr gdy brak). Wartosc moze byc
+    // zmieniana, wiec gdy klucz jest w segmencie wspoldzielonym z migawka,
+    // segment jest najpierw kopiowany. Sam odczyt powinien isc przez const
+    // find() albo get(), ktore niczego nie kopiuja.
+    V* find(const K& key) {
+        // W trakcie migracji klucz moze byc jeszcze w starej tablicy
+        int index = findInOldTable(key);
+        if (index != -1) {
+            return &oldTable.write(index).value;
+        }
+
+        index = findIndex(key);
+        if (index == -1) {
+            return nullptr;
+        }
+        return &table.write(index).value;
+    }
+
+    const V* find(const K& key) const {
+        int index = findInOldTable(key);
+        if (index != -1) {
+            return &oldTable[index].value;
+        }
+
+        index = findIndex(key);
+        if (index == -1) {
+            return nullptr;
+        }
+        return &table[index].value;
+    }
+
+    // Pobieranie kopii wartosci dla klucza
+    optional<V> get(const K& key) const {
+        const V* value = find(key);
+        if (value == nullptr) {
+            return nullopt;
+        }
+        return *value;
+    }
+
+    // Dopasowanie pojemnosci tak, zeby n elementow miescilo sie bez zmiany
+    // rozmiaru. Trwajaca migracja jest konczona. Tablica nigdy sie nie zmniejsza;
+    // jesli miejsca brakuje tylko przez nagrobki, sa one usuwane.
+    void reserve(int n) {
+        if (capacity == 0) {
+            init(capacityFor(n), incrementalResize);
+            return;
+        }
+
+        finishMigration();
+
+        int newCapacity = capacityFor(n);
+        if (newCapacity > capacity) {
+            resize(newCapacity);
+        }
+        else if (n + tombstones > capacity * LOAD_FACTOR_THRESHOLD) {
+            compact();
+        }
+    }
+
+    // Wstawienie count par (keys[i], values[i]) z jednorazowym dopasowaniem
+    // pojemnosci - bez sprawdzania progu przy kazdym wstawieniu
+    void build(const K* keys, const V* values, int count) {
+        reserve(size + count);
+
+        for (int i = 0; i < count; i++) {
+            insertUnchecked<true>(keys[i], values[i]);
+        }
+    }
+
+    // Wsadowe wstawianie count par (keys[i], values[i]).
+    // Indeks jest liczony w insert ponownie, bo wstawienie moze zmienic
+    // rozmiar tablicy - pobrane miejsca przyspieszaja wtedy tylko reszte porcji.
+    void insertBatch(const K* keys, const V* values, int count) {
+        if (capacity == 0) {
+            init(16, incrementalResize);
+        }
+
+        int indices[BATCH_BLOCK];
+
+        for (int start = 0; start < count; start += BATCH_BLOCK) {
+            int end = min(start + BATCH_BLOCK, count);
+            prefetchSlots(keys, start, end, indices);
+
+            for (int i = start; i < end; i++) {
+                insertImpl<true>(keys[i], values[i]);
             }
+        }
+    }
 
-            // Jesli klucz zostal znaleziony i nie jest usuniety
-            if (table[probeIndex].key == key && !table[probeIndex].isDeleted) {
-                return table[probeIndex].value;
+    // Wsadowe wyszukiwanie count kluczy; results[i] dostaje kopie wartosci
+    // albo nullopt. Zwraca liczbe znalezionych kluczy.
+    int getBatch(const K* keys, int count, optional<V>* results) const {
+        if (capacity == 0) {
+            fill(results, results + count, nullopt);
+            return 0;
+        }
+
+        int indices[BATCH_BLOCK];
+        int found = 0;
+
+        for (int start = 0; start < count; start += BATCH_BLOCK) {
+            int end = min(start + BATCH_BLOCK, count);
+            prefetchSlots(keys, start, end, indices);
+
+            for (int i = start; i < end; i++) {
+                // W trakcie migracji klucz moze byc jeszcze w starej tablicy
+                int oldIndex = findInOldTable(keys[i]);
+                if (oldIndex != -1) {
+                    results[i] = oldTable[oldIndex].value;
+                    found++;
+                    continue;
+                }
+
+                int index = probe(keys[i], indices[i - start]);
+                if (index != -1) {
+                    results[i] = table[index].value;
+                    found++;
+                }
+                else {
+                    results[i] = nullopt;
+                }
             }
+        }
 
-            i++;
+        return found;
+    }
+
+    // Wsadowe usuwanie count kluczy. Zwraca liczbe usunietych kluczy.
+    int removeBatch(const K* keys, int count) {
+        if (capacity == 0) {
+            return 0;
         }
 
-        return -1;
+        int removed = 0;
+
+        // Migracja przenosi miejsca przy kazdym usunieciu - bez wsadu
+        if (!oldTable.empty()) {
+            for (int i = 0; i < count; i++) {
+                if (remove(keys[i])) {
+                    removed++;
+                }
+            }
+            return removed;
+        }
+
+        int indices[BATCH_BLOCK];
+
+        for (int start = 0; start < count; start += BATCH_BLOCK) {
+            int end = min(start + BATCH_BLOCK, count);
+            prefetchSlots(keys, start, end, indices);
+
+            for (int i = start; i < end; i++) {
+                int index = probe(keys[i], indices[i - start]);
+                if (index != -1) {
+                    erase(table.write(index));
+                    tombstones++;
+                    removed++;
+                }
+            }
+        }
+
+        return removed;
     }
 
     // Czyszczenie tablicy mieszajacej
     void clear() {
-        delete[] table;
+        oldTable.release();
         capacity = 16;
         size = 0;
-        table = new Pair[capacity];
+        tombstones = 0;
+        table.allocate(capacity);
+        policy.setCapacity(capacity);
     }
 
     // Pobieranie aktualnego rozmiaru
-    int getSize() {
+    int getSize() const {
         return size;
     }
+
+    // Pojemnosc tablicy (liczba miejsc)
+    int getCapacity() const {
+        return capacity;
+    }
+
+    // Statystyki struktury: dlugosci sondowania elementow (od miejsca
+    // docelowego) i liczba nagrobkow. W trakcie migracji uwzglednia tez
+    // elementy starej tablicy; nagrobki sa tylko z biezacej.
+    TableStats getStats() const {
+        TableStats stats;
+        stats.size = size;
+        stats.capacity = capacity;
+        stats.tombstones = tombstones;
+
+        for (int i = 0; i < capacity; i++) {
+            if (table[i].isOccupied && !table[i].isDeleted) {
+                stats.probeLengths.add(((i - hash(table[i].key)) & (capacity - 1)) + 1);
+            }
+        }
+
+        for (int i = migrateIndex; i < oldCapacity && !oldTable.empty(); i++) {
+            if (oldTable[i].isOccupied && !oldTable[i].isDeleted) {
+                int home = oldPolicy(hasher(oldTable[i].key));
+                stats.probeLengths.add(((i - home) & (oldCapacity - 1)) + 1);
+            }
+        }
+
+#ifdef HASH_TABLE_STATS
+        counters.fill(stats);
+#endif
+        return stats;
+    }
+
+    // Pamiec zajmowana przez tablice (w bajtach)
+    long long getMemoryUsage() const {
+        long long oldBytes = !oldTable.empty() ? (long long)oldCapacity * sizeof(Pair) : 0;
+        return (long long)sizeof(*this) + (long long)capacity * sizeof(Pair) + oldBytes;
+    }
 };
 
 #endif
@@ -0,0 +1,270 @@
+#ifndef OPEN_ADDRESSING_SOA_HPP
+#define OPEN_ADDRESSING_SOA_HPP
+
+#include <iostream>
+#include <climits>
+#include <functional>
+#include "hash_policy.hpp"
+
+using namespace std;
+
+// Tablica mieszajaca z adresowaniem otwartym (sondowanie liniowe) w ukladzie
+// "struktura tablic": klucze i wartosci leza w osobnych tablicach, a stan
+// miejsca (puste / usuniete) jest zakodowany zarezerwowanymi wartosciami klucza.
+// Miejsce zajmuje 8 bajtow zamiast 12 (Pair z dwoma flagami bool), a sondowanie
+// czyta tylko gesto upakowane klucze. Indeksowanie (polityka Fibonacciego,
+// pojemnosc bedaca potega dwojki) i liczenie nagrobkow do progu sa takie
+// same jak w HashTableOpenAddressing.
+class HashTableOpenAddressingSoA {
+private:
+    // Wartownicy w tablicy kluczy
+    static const int EMPTY_KEY = INT_MIN;
+    static const int DELETED_KEY = INT_MIN + 1;
+
+    int* keys;
+    int* values;
+    int capacity;
+    int size;           // liczba elementow w tablicach (bez kluczy-wartownikow)
+    int tombstones;     // miejsca z DELETED_KEY - licza sie do progu
+    const double LOAD_FACTOR_THRESHOLD = 0.7;
+    std::hash<int> hasher;   // kwalifikowane - metoda hash() przeslania nazwe
+    FibonacciHash policy;
+
+    // Klucze rowne wartownikom sa przechowywane poza tablica
+    bool hasEmptyKey;
+    int emptyKeyValue;
+    bool hasDeletedKey;
+    int deletedKeyValue;
+
+    // Indeks miejsca dla klucza
+    int hash(int key) const {
+        return policy(hasher(key));
+    }
+
+    // Przydzielenie pustych tablic o zadanej pojemnosci
+    void allocate(int newCapacity) {
+        capacity = newCapacity;
+        keys = new int[capacity];
+        values = new int[capacity];
+        size = 0;
+        tombstones = 0;
+        policy.setCapacity(capacity);
+
+        for (int i = 0; i < capacity; i++) {
+            keys[i] = EMPTY_KEY;
+        }
+    }
+
+    // Skopiowanie zawartosci innej tablicy (tablice musza byc juz zwolnione)
+    void copyFrom(const HashTableOpenAddressingSoA& other) {
+        capacity = other.capacity;
+        size = other.size;
+        tombstones = other.tombstones;
+        policy = other.policy;
+        keys = new int[capacity];
+        values = new int[capacity];
+
+        for (int i = 0; i < capacity; i++) {
+            keys[i] = other.keys[i];
+            values[i] = other.values[i];
+        }
+
+        hasEmptyKey = other.hasEmptyKey;
+        emptyKeyValue = other.emptyKeyValue;
+        hasDeletedKey = other.hasDeletedKey;
+        deletedKeyValue = other.deletedKeyValue;
+    }
+
+    // Przebudowa tablicy, gdy elementy i nagrobki razem przekrocza prog.
+    // Jesli elementy zajmuja mniej niz polowe progu, przewazaja nagrobki
+    // i wystarczy przemieszac tablice w tej samej pojemnosci; inaczej
+    // pojemnosc jest podwajana.
+    void resize() {
+        int oldCapacity = capacity;
+        int* oldKeys = keys;
+        int* oldValues = values;
+
+        bool sameCapacity = size < capacity * LOAD_FACTOR_THRESHOLD / 2;
+        allocate(sameCapacity ? capacity : capacity * 2);
+
+        for (int i = 0; i < oldCapacity; i++) {
+            if (oldKeys[i] != EMPTY_KEY && oldKeys[i] != DELETED_KEY) {
+                insert(oldKeys[i], oldValues[i]);
+            }
+        }
+
+        delete[] oldKeys;
+        delete[] oldValues;
+    }
+
+    // Wyszukanie indeksu klucza w tablicy (-1 gdy brak)
+    int find(int key) const {
+        int index = hash(key);
+        int mask = capacity - 1;
+        int i = 0;
+
+        while (i < capacity) {
+            int probeIndex = (index + i) & mask;
+
+            // Jesli miejsce jest puste, klucz nie istnieje
+            if (keys[probeIndex] == EMPTY_KEY) {
+                return -1;
+            }
+
+            if (keys[probeIndex] == key) {
+                return probeIndex;
+            }
+
+            i++;
+        }
+
+        return -1;
+    }
+
+public:
+    HashTableOpenAddressingSoA() {
+        allocate(16);
+        hasEmptyKey = false;
+        emptyKeyValue = 0;
+        hasDeletedKey = false;
+        deletedKeyValue = 0;
+    }
+
+    // Konstruktor kopiujacy
+    HashTableOpenAddressingSoA(const HashTableOpenAddressingSoA& other) {
+        copyFrom(other);
+    }
+
+    // Operator przypisania
+    HashTableOpenAddressingSoA& operator=(const HashTableOpenAddressingSoA& other) {
+        if (this != &other) {
+            delete[] keys;
+            delete[] values;
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    ~HashTableOpenAddressingSoA() {
+        delete[] keys;
+        delete[] values;
+    }
+
+    // Wstawianie pary klucz-wartosc
+    void insert(int key, int value) {
+        // Klucze-wartownicy
+        if (key == EMPTY_KEY) {
+            hasEmptyKey = true;
+            emptyKeyValue = value;
+            return;
+        }
+        if (key == DELETED_KEY) {
+            hasDeletedKey = true;
+            deletedKeyValue = value;
+            return;
+        }
+
+        // Sprawdzenie czy potrzebna jest zmiana rozmiaru - nagrobki wydluzaja
+        // sondowanie tak samo jak elementy, wiec licza sie do progu
+        if (size + tombstones >= capacity * LOAD_FACTOR_THRESHOLD) {
+            resize();
+        }
+
+        int index = hash(key);
+        int mask = capacity - 1;
+        int firstFree = -1;
+        int i = 0;
+
+        // Sondowanie liniowe - pierwsze usuniete miejsce jest zapamietywane,
+        // ale szukanie trwa dalej, zeby nie zdublowac istniejacego klucza
+        while (i < capacity) {
+            int probeIndex = (index + i) & mask;
+
+            if (keys[probeIndex] == EMPTY_KEY) {
+                if (firstFree == -1) {
+                    firstFree = probeIndex;
+                }
+                break;
+            }
+
+            if (keys[probeIndex] == DELETED_KEY) {
+                if (firstFree == -1) {
+                    firstFree = probeIndex;
+                }
+            }
+            else if (keys[probeIndex] == key) {
+                // Jesli klucz juz istnieje, aktualizuj wartosc
+                values[probeIndex] = value;
+                return;
+            }
+
+            i++;
+        }
+
+        if (firstFree != -1) {
+            if (keys[firstFree] == DELETED_KEY) {
+                tombstones--;
+            }
+            keys[firstFree] = key;
+            values[firstFree] = value;
+            size++;
+        }
+    }
+
+    // Usuwanie pary klucz-wartosc
+    bool remove(int key) {
+        if (key == EMPTY_KEY || key == DELETED_KEY) {
+            bool& present = (key == EMPTY_KEY) ? hasEmptyKey : hasDeletedKey;
+            bool removed = present;
+            present = false;
+            return removed;
+        }
+
+        int index = find(key);
+        if (index == -1) {
+            return false;
+        }
+
+        keys[index] = DELETED_KEY;
+        size--;
+        tombstones++;
+        return true;
+    }
+
+    // Pobieranie wartosci dla klucza
+    int get(int key) {
+        if (key == EMPTY_KEY) {
+            return hasEmptyKey ? emptyKeyValue : -1;
+        }
+        if (key == DELETED_KEY) {
+            return hasDeletedKey ? deletedKeyValue : -1;
+        }
+
+        int index = find(key);
+        if (index == -1) {
+            return -1;
+        }
+        return values[index];
+    }
+
+    // Czyszczenie tablicy mieszajacej
+    void clear() {
+        delete[] keys;
+        delete[] values;
+        allocate(16);
+        hasEmptyKey = false;
+        hasDeletedKey = false;
+    }
+
+    // Pobieranie aktualnego rozmiaru
+    int getSize() {
+        return size + (hasEmptyKey ? 1 : 0) + (hasDeletedKey ? 1 : 0);
+    }
+
+    // Pamiec zajmowana przez tablice (w bajtach)
+    long long getMemoryUsage() {
+        return (long long)sizeof(*this) + (long long)capacity * (sizeof(int) + sizeof(int));
+    }
+};
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef PREFETCH_HPP
+#define PREFETCH_HPP
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+// Programowe pobieranie z wyprzedzeniem (prefetch) dla operacji wsadowych.
+// Operacje wsadowe tablic (insertBatch, getBatch, removeBatch) przetwarzaja
+// klucze porcjami po BATCH_BLOCK: najpierw licza indeksy wszystkich kluczy
+// porcji i zlecaja pobranie kubelkow, a dopiero potem wykonuja operacje,
+// dzieki czemu oczekiwanie na pamiec dla wielu kluczy sie naklada.
+
+// Liczba kluczy, dla ktorych pobieranie jest zlecane naraz
+const int BATCH_BLOCK = 16;
+
+// Zlecenie pobrania linii pamieci do odczytu
+inline void prefetchRead(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address, 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch((const char*)address, _MM_HINT_T0);
+#else
+    (void)address;
+#endif
+}
+
+// Zlecenie pobrania linii pamieci, ktora bedzie modyfikowana
+inline void prefetchWrite(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address, 1, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch((const char*)address, _MM_HINT_T0);
+#else
+    (void)address;
+#endif
+}
+
+#endif
@@ -0,0 +1,232 @@
+#ifndef ROBIN_HOOD_HPP
+#define ROBIN_HOOD_HPP
+
+#include <iostream>
+#include <algorithm>
+#include <utility>
+
+using namespace std;
+
+// Tablica mieszajaca z adresowaniem otwartym i sondowaniem Robin Hood.
+// Kazdy element pamieta swoja odleglosc od pozycji docelowej; przy wstawianiu
+// element "biedniejszy" (dalej od domu) zabiera miejsce "bogatszemu", a przy
+// usuwaniu kolejne elementy sa przesuwane wstecz, wiec nie ma znacznikow usuniecia.
+class HashTableRobinHood {
+private:
+    // Struktura pary klucz-wartosc z odlegloscia od pozycji docelowej
+    struct Slot {
+        int key;
+        int value;
+        int distance;   // 0 - miejsce puste, 1 - element na swojej pozycji docelowej
+
+        Slot() : key(0), value(0), distance(0) {}
+    };
+
+    Slot* table;
+    int capacity;
+    int size;
+    int shift;
+    const double LOAD_FACTOR_THRESHOLD = 0.9;
+
+    // Gorne ograniczenie dlugosci sondowania - dluzszy ciag wymusza powiekszenie tablicy
+    static const int MAX_DISTANCE = 128;
+
+    // Mieszanie Fibonacciego (pojemnosc jest zawsze potega dwojki)
+    int hash(int key) const {
+        return (int)(((unsigned int)key * 2654435769u) >> shift);
+    }
+
+    // Przydzielenie pustej tablicy o zadanej pojemnosci
+    void allocate(int newCapacity) {
+        capacity = newCapacity;
+        table = new Slot[capacity];
+        size = 0;
+
+        shift = 32;
+        for (int c = capacity; c > 1; c >>= 1) {
+            shift--;
+        }
+    }
+
+    // Zmiana rozmiaru tablicy gdy wspolczynnik wypelnienia przekroczy prog
+    void resize() {
+        int oldCapacity = capacity;
+        Slot* oldTable = table;
+
+        allocate(capacity * 2);
+
+        for (int i = 0; i < oldCapacity; i++) {
+            if (oldTable[i].distance != 0) {
+                place(oldTable[i].key, oldTable[i].value);
+            }
+        }
+
+        delete[] oldTable;
+    }
+
+    // Wstawienie klucza, o ktorym wiadomo, ze nie ma go w tablicy
+    void place(int key, int value) {
+        Slot entry;
+        entry.key = key;
+        entry.value = value;
+        entry.distance = 1;
+
+        int mask = capacity - 1;
+        int index = hash(key);
+
+        while (true) {
+            // Puste miejsce - koniec wstawiania
+            if (table[index].distance == 0) {
+                table[index] = entry;
+                size++;
+                return;
+            }
+
+            // Zabranie miejsca elementowi blizszemu swojej pozycji docelowej
+            if (table[index].distance < entry.distance) {
+                swap(entry, table[index]);
+            }
+
+            index = (index + 1) & mask;
+            entry.distance++;
+
+            // Zbyt dlugi ciag sondowania - powiekszenie tablicy i wstawienie
+            // niesionego elementu od nowa
+            if (entry.distance > MAX_DISTANCE) {
+                resize();
+                place(entry.key, entry.value);
+                return;
+            }
+        }
+    }
+
+    // Wyszukanie indeksu miejsca z kluczem (-1 gdy brak)
+    int find(int key) const {
+        int mask = capacity - 1;
+        int index = hash(key);
+        int distance = 1;
+
+        // Element blizej swojego domu niz szukany (lub puste miejsce) oznacza,
+        // ze szukanego klucza nie ma dalej w ciagu
+        while (table[index].distance >= distance) {
+            if (table[index].key == key) {
+                return index;
+            }
+
+            index = (index + 1) & mask;
+            distance++;
+        }
+
+        return -1;
+    }
+
+public:
+    HashTableRobinHood() {
+        allocate(16);
+    }
+
+    // Konstruktor kopiujacy
+    HashTableRobinHood(const HashTableRobinHood& other) {
+        capacity = other.capacity;
+        size = other.size;
+        shift = other.shift;
+        table = new Slot[capacity];
+
+        for (int i = 0; i < capacity; i++) {
+            table[i] = other.table[i];
+        }
+    }
+
+    // Operator przypisania
+    HashTableRobinHood& operator=(const HashTableRobinHood& other) {
+        if (this != &other) {
+            delete[] table;
+
+            capacity = other.capacity;
+            size = other.size;
+            shift = other.shift;
+            table = new Slot[capacity];
+
+            for (int i = 0; i < capacity; i++) {
+                table[i] = other.table[i];
+            }
+        }
+        return *this;
+    }
+
+    ~HashTableRobinHood() {
+        delete[] table;
+    }
+
+    // Wstawianie pary klucz-wartosc
+    void insert(int key, int value) {
+        // Jesli klucz juz istnieje, aktualizuj wartosc
+        int index = find(key);
+        if (index != -1) {
+            table[index].value = value;
+            return;
+        }
+
+        // Sprawdzenie czy potrzebna jest zmiana rozmiaru
+        if ((double)(size + 1) / capacity > LOAD_FACTOR_THRESHOLD) {
+            resize();
+        }
+
+        place(key, value);
+    }
+
+    // Usuwanie pary klucz-wartosc (przesuniecie wstecz zamiast znacznika usuniecia)
+    bool remove(int key) {
+        int index = find(key);
+        if (index == -1) {
+            return false;
+        }
+
+        int mask = capacity - 1;
+        int next = (index + 1) & mask;
+
+        // Przesuwanie kolejnych elementow o jedno miejsce blizej ich domu,
+        // az do pustego miejsca lub elementu stojacego na swojej pozycji
+        while (table[next].distance > 1) {
+            table[index] = table[next];
+            table[index].distance--;
+            index = next;
+            next = (next + 1) & mask;
+        }
+
+        table[index] = Slot();
+        size--;
+        return true;
+    }
+
+    // Pobieranie wartosci dla klucza
+    int get(int key) {
+        int index = find(key);
+        if (index == -1) {
+            return -1;
+        }
+        return table[index].value;
+    }
+
+    // Czyszczenie tablicy mieszajacej
+    void clear() {
+        delete[] table;
+        allocate(16);
+    }
+
+    // Pobieranie aktualnego rozmiaru
+    int getSize() {
+        return size;
+    }
+
+    // Najdluzszy ciag sondowania w tablicy
+    int getMaxProbeLength() {
+        int maxDistance = 0;
+        for (int i = 0; i < capacity; i++) {
+            maxDistance = max(maxDistance, table[i].distance);
+        }
+        return maxDistance;
+    }
+};
+
+#endif
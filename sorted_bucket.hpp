@@ -0,0 +1,776 @@
+#ifndef SORTED_BUCKET_HPP
+#define SORTED_BUCKET_HPP
+
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <type_traits>
+#include <cstdint>
+#include "node_pool.hpp"
+#include "prefetch.hpp"
+
+// SSE2 jest dostepne na kazdym procesorze x86-64, dla innych platform
+// zostaje wersja skalarna
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SORTED_BUCKET_SSE2 1
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using namespace std;
+
+// Kubelek tablicy HashTableAVL zamiast drzewa AVL (parametr Bucket tablicy).
+// Pary leza w posortowanych tablicach w wezlach rozmiaru dwoch linii pamieci
+// podrecznej: klucze w pierwszej, wartosci w drugiej. Tablica kluczy jest
+// przeszukiwana bez rozgalezien - pozycja to liczba kluczy mniejszych od
+// szukanego (dla kluczy int z less<int> po cztery naraz instrukcjami SSE2).
+// Przepelniony lisc dzieli sie jak w B+-drzewie: wyzej powstaja wezly
+// wewnetrzne z kluczami rozdzielajacymi, a wszystkie liscie leza na tej samej
+// glebokosci. Kubelek z kilkoma parami (typowy przy wspolczynniku
+// wypelnienia 1) to jeden maly lisc w polowie linii - tyle pamieci co wezel
+// AVL i jedno chybienie na wyszukiwanie; przepelniony zamienia sie w zwykly
+// lisc. Klucz int jest szukany przez porownanie na rownosc calej
+// tablicy kluczy liscia.
+// K i V musza miec konstruktor domyslny (tablice w wezlach).
+template <typename K = int, typename V = int, typename Compare = less<K>>
+class SortedArrayBucket {
+private:
+    static constexpr int NODE_BYTES = 128;   // dwie linie pamieci podrecznej
+    static constexpr int SMALL_NODE_BYTES = 32;    // polowa linii
+
+    // Pary w lisciu i dzieci wezla wewnetrznego tak, zeby wezel miescil sie
+    // w NODE_BYTES (z licznikiem i dopelnieniem kluczy)
+    static constexpr int LEAF_CAPACITY =
+        max<int>(2, (int)((NODE_BYTES - sizeof(int) - 3 * sizeof(K)) / (sizeof(K) + sizeof(V))));
+    static constexpr int SMALL_CAPACITY =
+        max<int>(1, (int)((SMALL_NODE_BYTES - sizeof(int) - 3 * sizeof(K)) / (sizeof(K) + sizeof(V))));
+    static constexpr int INNER_CAPACITY =
+        max<int>(2, (int)((NODE_BYTES - sizeof(int) - 3 * sizeof(K) - sizeof(void*)) / (sizeof(K) + sizeof(void*))));
+
+    // Tablice kluczy sa dopelnione do wielokrotnosci 4 (blok SSE2)
+    static constexpr int INNER_KEY_SLOTS = (INNER_CAPACITY + 3) & ~3;
+
+    // Najwieksza glebokosc wezlow wewnetrznych; sasiednie wezly sa laczone,
+    // gdy sie mieszcza, wiec nawet przy INNER_CAPACITY = 2 dla 2^31 par
+    // wystarcza z zapasem
+    static constexpr int MAX_DEPTH = 64;
+
+    // Lisc z CAPACITY parami, wyrownany do ALIGN bajtow (nie przekracza
+    // granicy linii, jesli sie w niej miesci)
+    template <int CAPACITY, int ALIGN>
+    struct alignas(ALIGN) LeafNode {
+        static constexpr int capacity = CAPACITY;
+
+        K keys[(CAPACITY + 3) & ~3];
+        V values[CAPACITY];
+        int count;
+
+        LeafNode() : count(0) {}
+    };
+
+    typedef LeafNode<LEAF_CAPACITY, 64> Leaf;
+    typedef LeafNode<SMALL_CAPACITY, SMALL_NODE_BYTES> SmallLeaf;   // jedyny wezel kubelka z co najwyzej SMALL_CAPACITY parami
+
+    // keys[i] rozdziela children[i] i children[i + 1]: klucze w children[i + 1]
+    // nie sa mniejsze od keys[i], a klucze w children[i] sa od niego mniejsze
+    struct alignas(64) Inner {
+        K keys[INNER_KEY_SLOTS];
+        void* children[INNER_CAPACITY + 1];
+        int count;   // liczba dzieci
+
+        Inner() : count(0) {}
+    };
+
+public:
+    // Pule lisci i wezlow wewnetrznych wspolne dla wszystkich kubelkow jednej tablicy
+    struct Pool {
+        NodePool<SmallLeaf> smallLeaves;
+        NodePool<Leaf> leaves;
+        NodePool<Inner> inners;
+
+        void releaseAll() {
+            smallLeaves.releaseAll();
+            leaves.releaseAll();
+            inners.releaseAll();
+        }
+
+        PoolStats getStats() const {
+            PoolStats stats = smallLeaves.getStats();
+            add(stats, leaves.getStats());
+            add(stats, inners.getStats());
+            return stats;
+        }
+
+    private:
+        static void add(PoolStats& stats, const PoolStats& other) {
+            stats.slabs += other.slabs;
+            stats.capacity += other.capacity;
+            stats.inUse += other.inUse;
+            stats.freeListed += other.freeListed;
+            stats.allocations += other.allocations;
+            stats.bytes += other.bytes;
+        }
+    };
+
+private:
+    void* root;     // lisc, gdy height == 0
+    int size;
+    int height;     // poziomy wezlow wewnetrznych nad liscmi
+    Pool* pool;     // nullptr - wezly przydzielane przez new/delete
+    bool small;     // root to SmallLeaf
+    Compare compare;
+
+    SmallLeaf* newSmallLeaf() {
+        return pool != nullptr ? pool->smallLeaves.allocate() : new SmallLeaf();
+    }
+
+    void freeSmallLeaf(SmallLeaf* leaf) {
+        if (pool != nullptr) {
+            pool->smallLeaves.deallocate(leaf);
+        }
+        else {
+            delete leaf;
+        }
+    }
+
+    Leaf* newLeaf() {
+        return pool != nullptr ? pool->leaves.allocate() : new Leaf();
+    }
+
+    void freeLeaf(Leaf* leaf) {
+        if (pool != nullptr) {
+            pool->leaves.deallocate(leaf);
+        }
+        else {
+            delete leaf;
+        }
+    }
+
+    Inner* newInner() {
+        return pool != nullptr ? pool->inners.allocate() : new Inner();
+    }
+
+    void freeInner(Inner* inner) {
+        if (pool != nullptr) {
+            pool->inners.deallocate(inner);
+        }
+        else {
+            delete inner;
+        }
+    }
+
+#ifdef SORTED_BUCKET_SSE2
+    // rank() dla kluczy int: cztery porownania jedna instrukcja, pozycje
+    // za count (dopelnienie tablicy) sa maskowane
+    template <bool upper>
+    static int rankInt(const int* keys, int count, int key) {
+        static const int8_t BITS[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+        __m128i needle = _mm_set1_epi32(key);
+        int pos = 0;
+
+        for (int i = 0; i < count; i += 4) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i));
+            int valid = count - i >= 4 ? 15 : (1 << (count - i)) - 1;
+            if (upper) {
+                // Klucze nie wieksze od szukanego - dopelnienie "wiekszych"
+                int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(block, needle)));
+                pos += BITS[~mask & valid];
+            }
+            else {
+                int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(block, needle)));
+                pos += BITS[mask & valid];
+            }
+        }
+        return pos;
+    }
+#endif
+
+    // Liczba kluczy keys[0..count) mniejszych od key (upper = false) albo
+    // nie wiekszych od key (upper = true), liczona bez rozgalezien
+    template <bool upper>
+    int rank(const K* keys, int count, const K& key) const {
+#ifdef SORTED_BUCKET_SSE2
+        if constexpr (is_same<K, int>::value && is_same<Compare, less<int>>::value) {
+            return rankInt<upper>(keys, count, key);
+        }
+#endif
+        int pos = 0;
+        for (int i = 0; i < count; i++) {
+            pos += upper ? !compare(key, keys[i]) : compare(keys[i], key);
+        }
+        return pos;
+    }
+
+    // Zejscie do liscia klucza; nodes[level] i index[level] - wezly
+    // wewnetrzne na sciezce i numery wybranych dzieci (tylko gdy nodes != nullptr)
+    Leaf* descend(const K& key, Inner** nodes, int* index) const {
+        void* node = root;
+        for (int level = 0; level < height; level++) {
+            Inner* inner = static_cast<Inner*>(node);
+            int i = rank<true>(inner->keys, inner->count - 1, key);
+            if (nodes != nullptr) {
+                nodes[level] = inner;
+                index[level] = i;
+            }
+            node = inner->children[i];
+        }
+        return static_cast<Leaf*>(node);
+    }
+
+    // Zejscie do ostatniego liscia (jak descend)
+    Leaf* descendRightmost(Inner** nodes, int* index) const {
+        void* node = root;
+        for (int level = 0; level < height; level++) {
+            Inner* inner = static_cast<Inner*>(node);
+            nodes[level] = inner;
+            index[level] = inner->count - 1;
+            node = inner->children[inner->count - 1];
+        }
+        return static_cast<Leaf*>(node);
+    }
+
+#ifdef SORTED_BUCKET_SSE2
+    // Indeks najmlodszego ustawionego bitu maski
+    static int lowestBit(unsigned int mask) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return (int)index;
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+
+    // Pozycja klucza int w tablicy SLOTS kluczy (count zajetych) albo -1:
+    // porownanie na rownosc calej tablicy ze stala liczba iteracji, bez
+    // petli zaleznej od count
+    template <int SLOTS>
+    static int findInt(const int* keys, int count, int key) {
+        __m128i needle = _mm_set1_epi32(key);
+        unsigned int mask = 0;
+        for (int i = 0; i < SLOTS; i += 4) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i));
+            mask |= (unsigned int)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(block, needle))) << i;
+        }
+        mask &= (1u << count) - 1;
+        return mask != 0 ? lowestBit(mask) : -1;
+    }
+#endif
+
+    // Pozycja klucza w lisciu albo -1
+    template <typename Node>
+    int findInLeaf(const Node* leaf, const K& key) const {
+#ifdef SORTED_BUCKET_SSE2
+        if constexpr (is_same<K, int>::value && is_same<Compare, less<int>>::value) {
+            return findInt<(Node::capacity + 3) & ~3>(leaf->keys, leaf->count, key);
+        }
+#endif
+        int pos = rank<false>(leaf->keys, leaf->count, key);
+        return pos < leaf->count && !compare(key, leaf->keys[pos]) ? pos : -1;
+    }
+
+    // Wskaznik na wartosc klucza albo nullptr
+    V* findValue(const K& key) const {
+        if (root == nullptr) {
+            return nullptr;
+        }
+
+        if (small) {
+            SmallLeaf* leaf = static_cast<SmallLeaf*>(root);
+            int pos = findInLeaf(leaf, key);
+            return pos >= 0 ? &leaf->values[pos] : nullptr;
+        }
+
+        Leaf* leaf = descend(key, nullptr, nullptr);
+        int pos = findInLeaf(leaf, key);
+        return pos >= 0 ? &leaf->values[pos] : nullptr;
+    }
+
+    // Wstawienie pary na pozycje pos liscia, w ktorym jest miejsce
+    template <typename Node>
+    static void insertAt(Node* leaf, int pos, const K& key, V&& value) {
+        move_backward(leaf->keys + pos, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+        move_backward(leaf->values + pos, leaf->values + leaf->count, leaf->values + leaf->count + 1);
+        leaf->keys[pos] = key;
+        leaf->values[pos] = std::move(value);
+        leaf->count++;
+    }
+
+    // Usuniecie pary z pozycji pos liscia
+    template <typename Node>
+    static void removeAt(Node* leaf, int pos) {
+        move(leaf->keys + pos + 1, leaf->keys + leaf->count, leaf->keys + pos);
+        move(leaf->values + pos + 1, leaf->values + leaf->count, leaf->values + pos);
+        leaf->count--;
+    }
+
+    // Przeniesienie par [from, count) liscia na koniec innego liscia
+    template <typename From, typename To>
+    static void moveTail(From* leaf, int from, To* to) {
+        move(leaf->keys + from, leaf->keys + leaf->count, to->keys + to->count);
+        move(leaf->values + from, leaf->values + leaf->count, to->values + to->count);
+        to->count += leaf->count - from;
+        leaf->count = from;
+    }
+
+    // Dolaczenie dziecka child z kluczem rozdzielajacym separator tuz za
+    // dzieckiem index[level] wezla nodes[level] (level < 0 - nad korzeniem).
+    // Pelny wezel dzieli sie na polowy, a przy dopisywaniu na koncu (append)
+    // zostaje pelny, zeby budowa z posortowanego ciagu dawala pelne wezly.
+    void insertChild(Inner** nodes, int* index, int level, K separator, void* child, bool append) {
+        while (level >= 0) {
+            Inner* inner = nodes[level];
+            int at = index[level] + 1;
+
+            if (inner->count <= INNER_CAPACITY) {
+                for (int i = inner->count; i > at; i--) {
+                    inner->children[i] = inner->children[i - 1];
+                }
+                move_backward(inner->keys + at - 1, inner->keys + inner->count - 1, inner->keys + inner->count);
+                inner->children[at] = child;
+                inner->keys[at - 1] = std::move(separator);
+                inner->count++;
+                return;
+            }
+
+            // Podzial: INNER_CAPACITY + 2 dzieci razem z nowym
+            K keys[INNER_CAPACITY + 1];
+            void* children[INNER_CAPACITY + 2];
+            for (int i = 0, j = 0; i < INNER_CAPACITY + 2; i++) {
+                children[i] = i == at ? child : inner->children[j++];
+            }
+            for (int i = 0, j = 0; i < INNER_CAPACITY + 1; i++) {
+                keys[i] = i == at - 1 ? std::move(separator) : std::move(inner->keys[j++]);
+            }
+
+            int leftCount = append ? INNER_CAPACITY + 1 : (INNER_CAPACITY + 2) / 2;
+            Inner* right = newInner();
+            for (int i = 0; i < leftCount; i++) {
+                inner->children[i] = children[i];
+            }
+            move(keys, keys + leftCount - 1, inner->keys);
+            inner->count = leftCount;
+
+            for (int i = leftCount; i < INNER_CAPACITY + 2; i++) {
+                right->children[i - leftCount] = children[i];
+            }
+            move(keys + leftCount, keys + INNER_CAPACITY + 1, right->keys);
+            right->count = INNER_CAPACITY + 2 - leftCount;
+
+            // Klucz miedzy polowkami idzie poziom wyzej
+            separator = std::move(keys[leftCount - 1]);
+            child = right;
+            level--;
+        }
+
+        Inner* newRoot = newInner();
+        newRoot->children[0] = root;
+        newRoot->children[1] = child;
+        newRoot->keys[0] = std::move(separator);
+        newRoot->count = 2;
+        root = newRoot;
+        height++;
+    }
+
+    // Usuniecie dziecka c (c >= 1) i klucza przed nim
+    static void removeChild(Inner* inner, int c) {
+        for (int i = c; i + 1 < inner->count; i++) {
+            inner->children[i] = inner->children[i + 1];
+        }
+        move(inner->keys + c, inner->keys + inner->count - 1, inner->keys + c - 1);
+        inner->count--;
+    }
+
+    // Po usunieciu pary z liscia: polaczenie go z sasiadem, jesli obaj
+    // mieszcza sie w jednym lisciu, i tak samo dalej w gore dla wezlow
+    // wewnetrznych, ktore stracily dziecko. Korzen z jednym dzieckiem znika.
+    void mergeAfterRemove(Inner** nodes, int* index) {
+        if (height == 0) {
+            // Jedyny lisc, ktory zmalal do polowy malego, znow staje sie maly
+            if (size <= SMALL_CAPACITY / 2) {
+                Leaf* leaf = static_cast<Leaf*>(root);
+                SmallLeaf* smallLeaf = newSmallLeaf();
+                moveTail(leaf, 0, smallLeaf);
+                freeLeaf(leaf);
+                root = smallLeaf;
+                small = true;
+            }
+            return;
+        }
+
+        Inner* parent = nodes[height - 1];
+        int i = index[height - 1];
+        if (parent->count < 2) {
+            return;
+        }
+
+        int j = i + 1 < parent->count ? i : i - 1;
+        Leaf* left = static_cast<Leaf*>(parent->children[j]);
+        Leaf* right = static_cast<Leaf*>(parent->children[j + 1]);
+        if (left->count + right->count > LEAF_CAPACITY) {
+            return;
+        }
+        moveTail(right, 0, left);
+        freeLeaf(right);
+        removeChild(parent, j + 1);
+
+        for (int level = height - 1; level >= 0; level--) {
+            Inner* inner = nodes[level];
+            if (level == 0) {
+                if (inner->count == 1) {
+                    root = inner->children[0];
+                    freeInner(inner);
+                    height--;
+                }
+                return;
+            }
+
+            Inner* up = nodes[level - 1];
+            int k = index[level - 1];
+            if (up->count < 2) {
+                return;
+            }
+
+            int m = k + 1 < up->count ? k : k - 1;
+            Inner* a = static_cast<Inner*>(up->children[m]);
+            Inner* b = static_cast<Inner*>(up->children[m + 1]);
+            if (a->count + b->count > INNER_CAPACITY + 1) {
+                return;
+            }
+
+            // Klucz rozdzielajacy z rodzica schodzi miedzy klucze a i b
+            a->keys[a->count - 1] = std::move(up->keys[m]);
+            move(b->keys, b->keys + b->count - 1, a->keys + a->count);
+            for (int c = 0; c < b->count; c++) {
+                a->children[a->count + c] = b->children[c];
+            }
+            a->count += b->count;
+            freeInner(b);
+            removeChild(up, m + 1);
+        }
+    }
+
+    // Zamiana pelnego malego liscia w zwykly
+    void growSmall() {
+        SmallLeaf* smallLeaf = static_cast<SmallLeaf*>(root);
+        Leaf* leaf = newLeaf();
+        moveTail(smallLeaf, 0, leaf);
+        freeSmallLeaf(smallLeaf);
+        root = leaf;
+        small = false;
+    }
+
+    template <typename... Args>
+    bool insertImpl(const K& key, bool overwrite, Args&&... args) {
+        if (root == nullptr) {
+            root = newSmallLeaf();
+            small = true;
+            height = 0;
+        }
+
+        if (small) {
+            SmallLeaf* leaf = static_cast<SmallLeaf*>(root);
+            int pos = rank<false>(leaf->keys, leaf->count, key);
+            if (pos < leaf->count && !compare(key, leaf->keys[pos])) {
+                if (overwrite) {
+                    leaf->values[pos] = V(std::forward<Args>(args)...);
+                }
+                return false;
+            }
+
+            if (leaf->count < SMALL_CAPACITY) {
+                insertAt(leaf, pos, key, V(std::forward<Args>(args)...));
+                size++;
+                return true;
+            }
+            growSmall();
+        }
+
+        Inner* nodes[MAX_DEPTH];
+        int index[MAX_DEPTH];
+        Leaf* leaf = descend(key, nodes, index);
+        int pos = rank<false>(leaf->keys, leaf->count, key);
+
+        if (pos < leaf->count && !compare(key, leaf->keys[pos])) {
+            // Klucz juz istnieje, aktualizacja wartosci
+            if (overwrite) {
+                leaf->values[pos] = V(std::forward<Args>(args)...);
+            }
+            return false;
+        }
+
+        V value(std::forward<Args>(args)...);
+        size++;
+
+        if (leaf->count < LEAF_CAPACITY) {
+            insertAt(leaf, pos, key, std::move(value));
+            return true;
+        }
+
+        // Podzial pelnego liscia na polowy
+        Leaf* right = newLeaf();
+        int leftCount = (LEAF_CAPACITY + 1) / 2;
+        if (pos < leftCount) {
+            moveTail(leaf, leftCount - 1, right);
+            insertAt(leaf, pos, key, std::move(value));
+        }
+        else {
+            moveTail(leaf, leftCount, right);
+            insertAt(right, pos - leftCount, key, std::move(value));
+        }
+
+        insertChild(nodes, index, height - 1, right->keys[0], right, false);
+        return true;
+    }
+
+    // Odwiedzenie lisci w porzadku kluczy: visit(keys, values, count);
+    // glebokosc rekurencji to height
+    template <typename Visit>
+    void visitLeaves(void* node, int level, Visit& visit) const {
+        if (level == 0) {
+            if (small) {
+                SmallLeaf* leaf = static_cast<SmallLeaf*>(node);
+                visit(leaf->keys, leaf->values, leaf->count);
+            }
+            else {
+                Leaf* leaf = static_cast<Leaf*>(node);
+                visit(leaf->keys, leaf->values, leaf->count);
+            }
+            return;
+        }
+
+        Inner* inner = static_cast<Inner*>(node);
+        for (int i = 0; i < inner->count; i++) {
+            visitLeaves(inner->children[i], level - 1, visit);
+        }
+    }
+
+    void freeNodes(void* node, int level) {
+        if (small) {
+            freeSmallLeaf(static_cast<SmallLeaf*>(node));
+            return;
+        }
+
+        if (level == 0) {
+            freeLeaf(static_cast<Leaf*>(node));
+            return;
+        }
+
+        Inner* inner = static_cast<Inner*>(node);
+        for (int i = 0; i < inner->count; i++) {
+            freeNodes(inner->children[i], level - 1);
+        }
+        freeInner(inner);
+    }
+
+public:
+    SortedArrayBucket() : root(nullptr), size(0), height(0), pool(nullptr), small(false) {}
+
+    // Ustawienie puli wezlow (tylko dla pustego kubelka)
+    void setPool(Pool* nodePool) {
+        pool = nodePool;
+    }
+
+    // Wezly z puli zwalnia jej wlasciciel, wszystkie naraz - chyba ze
+    // wymagaja wywolania destruktora
+    ~SortedArrayBucket() {
+        if (pool == nullptr || !is_trivially_destructible<Leaf>::value) {
+            clear();
+        }
+    }
+
+    // Wstawianie pary klucz-wartosc (istniejaca wartosc jest nadpisywana)
+    // Zwraca true, jesli klucz zostal dodany.
+    bool insert(const K& key, V value) {
+        return insertImpl(key, true, std::move(value));
+    }
+
+    // Wstawienie wartosci zbudowanej z args, jesli klucza nie ma
+    // w kubelku. Zwraca true, jesli klucz zostal dodany.
+    template <typename... Args>
+    bool emplace(const K& key, Args&&... args) {
+        return insertImpl(key, false, std::forward<Args>(args)...);
+    }
+
+    // Usuwanie pary klucz-wartosc
+    bool remove(const K& key) {
+        if (root == nullptr) {
+            return false;
+        }
+
+        if (small) {
+            SmallLeaf* leaf = static_cast<SmallLeaf*>(root);
+            int pos = findInLeaf(leaf, key);
+            if (pos < 0) {
+                return false;
+            }
+
+            removeAt(leaf, pos);
+            size--;
+            if (size == 0) {
+                clear();
+            }
+            return true;
+        }
+
+        Inner* nodes[MAX_DEPTH];
+        int index[MAX_DEPTH];
+        Leaf* leaf = descend(key, nodes, index);
+        int pos = findInLeaf(leaf, key);
+        if (pos < 0) {
+            return false;
+        }
+
+        removeAt(leaf, pos);
+        size--;
+
+        if (size == 0) {
+            clear();
+        }
+        else {
+            mergeAfterRemove(nodes, index);
+        }
+        return true;
+    }
+
+    // Wskaznik na wartosc dla klucza (nullptr gdy brak)
+    V* find(const K& key) {
+        return findValue(key);
+    }
+
+    const V* find(const K& key) const {
+        return findValue(key);
+    }
+
+    // Odwiedzenie wszystkich par w porzadku kluczy: visit(key, value)
+    template <typename Visit>
+    void forEach(Visit visit) const {
+        if (root == nullptr) {
+            return;
+        }
+
+        auto visitLeaf = [&](const K* keys, const V* values, int count) {
+            for (int i = 0; i < count; i++) {
+                visit(keys[i], values[i]);
+            }
+        };
+        visitLeaves(root, height, visitLeaf);
+    }
+
+    // Przekazanie wszystkich par w porzadku kluczy: visit(K&& key, V&& value);
+    // kubelek zostaje pusty
+    template <typename Visit>
+    void drain(Visit visit) {
+        if (root == nullptr) {
+            return;
+        }
+
+        auto visitLeaf = [&](K* keys, V* values, int count) {
+            for (int i = 0; i < count; i++) {
+                visit(std::move(keys[i]), std::move(values[i]));
+            }
+        };
+        visitLeaves(root, height, visitLeaf);
+        clear();
+    }
+
+    // Budowa z ciagu posortowanego (interfejs jak w AVLTree): pary z rosnacymi
+    // kluczami sa dopisywane na koniec ostatniego liscia, a pelne liscie
+    // i wezly wewnetrzne zostaja pelne. Para, ktora nie jest wieksza od
+    // ostatniej, jest wstawiana zwyczajnie (obecny klucz zostaje).
+    template <typename... Args>
+    void pushSorted(const K& key, Args&&... args) {
+        if (root == nullptr) {
+            root = newSmallLeaf();
+            small = true;
+            height = 0;
+        }
+
+        if (small) {
+            SmallLeaf* leaf = static_cast<SmallLeaf*>(root);
+            if (leaf->count > 0 && !compare(leaf->keys[leaf->count - 1], key)) {
+                insertImpl(key, false, std::forward<Args>(args)...);
+                return;
+            }
+            if (leaf->count < SMALL_CAPACITY) {
+                leaf->keys[leaf->count] = key;
+                leaf->values[leaf->count] = V(std::forward<Args>(args)...);
+                leaf->count++;
+                size++;
+                return;
+            }
+            growSmall();
+        }
+
+        Inner* nodes[MAX_DEPTH];
+        int index[MAX_DEPTH];
+        Leaf* leaf = descendRightmost(nodes, index);
+        if (leaf->count == 0 ? size > 0 : !compare(leaf->keys[leaf->count - 1], key)) {
+            insertImpl(key, false, std::forward<Args>(args)...);
+            return;
+        }
+
+        size++;
+        if (leaf->count < LEAF_CAPACITY) {
+            leaf->keys[leaf->count] = key;
+            leaf->values[leaf->count] = V(std::forward<Args>(args)...);
+            leaf->count++;
+            return;
+        }
+
+        Leaf* right = newLeaf();
+        right->keys[0] = key;
+        right->values[0] = V(std::forward<Args>(args)...);
+        right->count = 1;
+        insertChild(nodes, index, height - 1, key, right, true);
+    }
+
+    // Kubelek jest poprawny po kazdym pushSorted(), wiec nie ma nic do zrobienia
+    void finishSorted() {}
+
+    // Rozdzielenie par miedzy kubelki target(key) przez pushSorted();
+    // kubelek zostaje pusty
+    template <typename Target>
+    void distribute(Target target) {
+        drain([&](K&& key, V&& value) {
+            target(static_cast<const K&>(key)).pushSorted(key, std::move(value));
+        });
+    }
+
+    // Czyszczenie kubelka
+    void clear() {
+        if (root != nullptr) {
+            freeNodes(root, height);
+        }
+        root = nullptr;
+        size = 0;
+        height = 0;
+        small = false;
+    }
+
+    // Zlecenie pobrania korzenia (obu linii zwyklego wezla)
+    void prefetchRoot() const {
+        if (root != nullptr) {
+            prefetchRead(root);
+            if (!small) {
+                prefetchRead(static_cast<const char*>(root) + 64);
+            }
+        }
+    }
+
+    // Pobieranie aktualnego rozmiaru
+    int getSize() const {
+        return size;
+    }
+
+    // Liczba poziomow wezlow (0 - pusty, 1 - sam lisc)
+    int getHeight() const {
+        return root != nullptr ? height + 1 : 0;
+    }
+};
+
+#endif
@@ -0,0 +1,319 @@
+#ifndef SWISS_TABLE_HPP
+#define SWISS_TABLE_HPP
+
+#include <iostream>
+#include <cstdint>
+#include <cstring>
+
+// SSE2 jest dostepne na kazdym procesorze x86-64, dla innych platform
+// zostaje wersja skalarna
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SWISS_TABLE_SSE2 1
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using namespace std;
+
+// Tablica mieszajaca z adresowaniem otwartym w stylu "Swiss table".
+// Obok par klucz-wartosc trzymana jest osobna tablica 1-bajtowych znacznikow
+// kontrolnych (7 bitow skrotu albo stan pusty/usuniety), dzieki czemu jedna
+// instrukcja SSE2 sprawdza od razu cala grupe 16 miejsc.
+class HashTableSwiss {
+private:
+    // Struktura pary klucz-wartosc
+    struct Slot {
+        int key;
+        int value;
+    };
+
+    static const int GROUP_SIZE = 16;
+    static const int8_t CTRL_EMPTY = -128;   // 0b10000000
+    static const int8_t CTRL_DELETED = -2;   // 0b11111110
+
+    int8_t* ctrl;
+    Slot* slots;
+    int capacity;
+    int size;
+    int tombstones;
+    int growthLeft;
+    const double LOAD_FACTOR_THRESHOLD = 0.875;
+
+    // Funkcja mieszajaca (finalizator MurmurHash3) - potrzebne sa dobre
+    // zarowno gorne bity (wybor grupy), jak i dolne (znacznik h2)
+    static unsigned int hash(int key) {
+        unsigned int h = (unsigned int)key;
+        h ^= h >> 16;
+        h *= 0x85ebca6bu;
+        h ^= h >> 13;
+        h *= 0xc2b2ae35u;
+        h ^= h >> 16;
+        return h;
+    }
+
+    // Znacznik zapisywany w bajcie kontrolnym zajetego miejsca (0..127)
+    static int8_t h2(unsigned int h) {
+        return (int8_t)(h & 0x7F);
+    }
+
+    // Indeks najmlodszego ustawionego bitu maski
+    static int lowestBit(unsigned int mask) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return (int)index;
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+
+    // Maska miejsc grupy, ktorych bajt kontrolny jest rowny value
+    static unsigned int matchByte(const int8_t* group, int8_t value) {
+#ifdef SWISS_TABLE_SSE2
+        __m128i ctrlBytes = _mm_loadu_si128((const __m128i*)group);
+        return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrlBytes, _mm_set1_epi8(value)));
+#else
+        unsigned int mask = 0;
+        for (int i = 0; i < GROUP_SIZE; i++) {
+            if (group[i] == value) {
+                mask |= 1u << i;
+            }
+        }
+        return mask;
+#endif
+    }
+
+    // Maska miejsc grupy, ktore sa puste lub usuniete (bajt kontrolny < -1)
+    static unsigned int matchEmptyOrDeleted(const int8_t* group) {
+#ifdef SWISS_TABLE_SSE2
+        __m128i ctrlBytes = _mm_loadu_si128((const __m128i*)group);
+        return (unsigned int)_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), ctrlBytes));
+#else
+        unsigned int mask = 0;
+        for (int i = 0; i < GROUP_SIZE; i++) {
+            if (group[i] < -1) {
+                mask |= 1u << i;
+            }
+        }
+        return mask;
+#endif
+    }
+
+    int groupMask() const {
+        return capacity / GROUP_SIZE - 1;
+    }
+
+    // Przydzielenie pustych tablic o zadanej pojemnosci
+    void allocate(int newCapacity) {
+        capacity = newCapacity;
+        ctrl = new int8_t[capacity];
+        slots = new Slot[capacity];
+        memset(ctrl, CTRL_EMPTY, capacity);
+        size = 0;
+        tombstones = 0;
+        growthLeft = (int)(capacity * LOAD_FACTOR_THRESHOLD);
+    }
+
+    // Wyszukanie indeksu miejsca z kluczem (-1 gdy brak)
+    int find(int key) const {
+        unsigned int h = hash(key);
+        int8_t tag = h2(h);
+        int mask = groupMask();
+        int group = (int)(h >> 7) & mask;
+
+        // Sondowanie kwadratowe po grupach
+        for (int i = 0; i <= mask; i++) {
+            const int8_t* groupCtrl = ctrl + group * GROUP_SIZE;
+
+            unsigned int candidates = matchByte(groupCtrl, tag);
+            while (candidates != 0) {
+                int index = group * GROUP_SIZE + lowestBit(candidates);
+                if (slots[index].key == key) {
+                    return index;
+                }
+                candidates &= candidates - 1;
+            }
+
+            // Pusta pozycja w grupie konczy sondowanie
+            if (matchByte(groupCtrl, CTRL_EMPTY) != 0) {
+                return -1;
+            }
+
+            group = (group + i + 1) & mask;
+        }
+
+        return -1;
+    }
+
+    // Wyszukanie pierwszego wolnego (pustego lub usunietego) miejsca dla skrotu
+    int findInsertSlot(unsigned int h) const {
+        int mask = groupMask();
+        int group = (int)(h >> 7) & mask;
+
+        for (int i = 0; i <= mask; i++) {
+            unsigned int freeSlots = matchEmptyOrDeleted(ctrl + group * GROUP_SIZE);
+            if (freeSlots != 0) {
+                return group * GROUP_SIZE + lowestBit(freeSlots);
+            }
+            group = (group + i + 1) & mask;
+        }
+
+        return -1;
+    }
+
+    // Ponowne mieszanie do tablicy o zadanej pojemnosci (usuwa tez znaczniki usuniecia)
+    void rehash(int newCapacity) {
+        int oldCapacity = capacity;
+        int8_t* oldCtrl = ctrl;
+        Slot* oldSlots = slots;
+
+        allocate(newCapacity);
+
+        for (int i = 0; i < oldCapacity; i++) {
+            if (oldCtrl[i] >= 0) {
+                unsigned int h = hash(oldSlots[i].key);
+                int index = findInsertSlot(h);
+                ctrl[index] = h2(h);
+                slots[index] = oldSlots[i];
+                size++;
+                growthLeft--;
+            }
+        }
+
+        delete[] oldCtrl;
+        delete[] oldSlots;
+    }
+
+    // Zmiana rozmiaru tablicy gdy skonczy sie zapas wolnych miejsc
+    void resize() {
+        // Jesli wiekszosc zajetych miejsc to znaczniki usuniecia, wystarczy
+        // przemieszac tablice w tym samym rozmiarze
+        if (size * 2 <= (int)(capacity * LOAD_FACTOR_THRESHOLD)) {
+            rehash(capacity);
+        }
+        else {
+            rehash(capacity * 2);
+        }
+    }
+
+public:
+    HashTableSwiss() {
+        allocate(16);
+    }
+
+    // Konstruktor kopiujacy
+    HashTableSwiss(const HashTableSwiss& other) {
+        capacity = other.capacity;
+        size = other.size;
+        tombstones = other.tombstones;
+        growthLeft = other.growthLeft;
+        ctrl = new int8_t[capacity];
+        slots = new Slot[capacity];
+
+        memcpy(ctrl, other.ctrl, capacity);
+        memcpy(slots, other.slots, capacity * sizeof(Slot));
+    }
+
+    // Operator przypisania
+    HashTableSwiss& operator=(const HashTableSwiss& other) {
+        if (this != &other) {
+            delete[] ctrl;
+            delete[] slots;
+
+            capacity = other.capacity;
+            size = other.size;
+            tombstones = other.tombstones;
+            growthLeft = other.growthLeft;
+            ctrl = new int8_t[capacity];
+            slots = new Slot[capacity];
+
+            memcpy(ctrl, other.ctrl, capacity);
+            memcpy(slots, other.slots, capacity * sizeof(Slot));
+        }
+        return *this;
+    }
+
+    ~HashTableSwiss() {
+        delete[] ctrl;
+        delete[] slots;
+    }
+
+    // Wstawianie pary klucz-wartosc
+    void insert(int key, int value) {
+        // Jesli klucz juz istnieje, aktualizuj wartosc
+        int index = find(key);
+        if (index != -1) {
+            slots[index].value = value;
+            return;
+        }
+
+        // Sprawdzenie czy potrzebna jest zmiana rozmiaru
+        if (growthLeft == 0) {
+            resize();
+        }
+
+        unsigned int h = hash(key);
+        index = findInsertSlot(h);
+
+        if (ctrl[index] == CTRL_EMPTY) {
+            growthLeft--;
+        }
+        else {
+            tombstones--;
+        }
+
+        ctrl[index] = h2(h);
+        slots[index].key = key;
+        slots[index].value = value;
+        size++;
+    }
+
+    // Usuwanie pary klucz-wartosc
+    bool remove(int key) {
+        int index = find(key);
+        if (index == -1) {
+            return false;
+        }
+
+        // Jesli grupa ma jeszcze puste miejsce, zadne sondowanie nie przeszlo
+        // przez nia dalej, wiec miejsce mozna od razu oznaczyc jako puste
+        const int8_t* groupCtrl = ctrl + (index / GROUP_SIZE) * GROUP_SIZE;
+        if (matchByte(groupCtrl, CTRL_EMPTY) != 0) {
+            ctrl[index] = CTRL_EMPTY;
+            growthLeft++;
+        }
+        else {
+            ctrl[index] = CTRL_DELETED;
+            tombstones++;
+        }
+
+        size--;
+        return true;
+    }
+
+    // Pobieranie wartosci dla klucza
+    int get(int key) {
+        int index = find(key);
+        if (index == -1) {
+            return -1;
+        }
+        return slots[index].value;
+    }
+
+    // Czyszczenie tablicy mieszajacej
+    void clear() {
+        delete[] ctrl;
+        delete[] slots;
+        allocate(16);
+    }
+
+    // Pobieranie aktualnego rozmiaru
+    int getSize() {
+        return size;
+    }
+};
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef TABLE_STATS_HPP
+#define TABLE_STATS_HPP
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+
+using namespace std;
+
+// Statystyki struktury tablic HashTableOpenAddressing, HashTableChaining
+// i HashTableAVL zwracane przez getStats(). Rozklady (dlugosci sondowania,
+// lancuchow, wysokosci drzew) sa liczone na zadanie przegladem tablicy,
+// wiec nic nie kosztuja, dopoki nikt ich nie pobiera.
+// Liczniki zmian rozmiaru i czasu przebudowy sa aktualizowane przy kazdej
+// zmianie rozmiaru, dlatego istnieja tylko z makrem HASH_TABLE_STATS
+// (zdefiniowanym przed dolaczeniem naglowkow tablic albo -DHASH_TABLE_STATS);
+// bez niego znikaja z tablic calkowicie.
+
+// Histogram wartosci calkowitych nieujemnych: counts[v] - liczba wystapien v
+class Histogram {
+private:
+    vector<long long> counts;
+
+public:
+    void add(int value, long long count = 1) {
+        if (value >= (int)counts.size()) {
+            counts.resize(value + 1, 0);
+        }
+        counts[value] += count;
+    }
+
+    bool empty() const {
+        return counts.empty();
+    }
+
+    // Najwieksza wartosc + 1
+    int buckets() const {
+        return (int)counts.size();
+    }
+
+    long long count(int value) const {
+        return value < (int)counts.size() ? counts[value] : 0;
+    }
+
+    long long total() const {
+        long long sum = 0;
+        for (size_t v = 0; v < counts.size(); v++) {
+            sum += counts[v];
+        }
+        return sum;
+    }
+
+    double mean() const {
+        long long sum = 0;
+        long long weighted = 0;
+        for (size_t v = 0; v < counts.size(); v++) {
+            sum += counts[v];
+            weighted += counts[v] * (long long)v;
+        }
+        return sum > 0 ? (double)weighted / sum : 0;
+    }
+
+    int max() const {
+        return counts.empty() ? 0 : (int)counts.size() - 1;
+    }
+
+    // Najmniejsza wartosc, ponizej lub na ktorej lezy p procent wystapien
+    int percentile(double p) const {
+        long long limit = (long long)(p / 100.0 * total() + 0.5);
+        long long sum = 0;
+        for (size_t v = 0; v < counts.size(); v++) {
+            sum += counts[v];
+            if (sum >= limit && sum > 0) {
+                return (int)v;
+            }
+        }
+        return max();
+    }
+};
+
+// Statystyki jednej tablicy. Histogramy, ktorych rodzaj tablicy nie ma,
+// zostaja puste.
+struct TableStats {
+    int size;
+    int capacity;
+    long long tombstones;          // adresowanie otwarte: miejsca oznaczone jako usuniete
+    Histogram probeLengths;        // adresowanie otwarte: sondowania do znalezienia elementu (1 - na miejscu)
+    Histogram chainLengths;        // lancuchowanie: elementy w kubelku (tez puste kubelki)
+    Histogram treeHeights;         // AVL: wysokosc drzewa w kubelku (0 - pusty)
+    Histogram treeSizes;           // AVL: elementy w kubelku
+    long long nodeBytes;           // tablice z wezlami: pamiec blokow puli wezlow (0 - brak wezlow)
+    bool countersEnabled;          // czy ponizsze liczniki sa dostepne (HASH_TABLE_STATS)
+    long long resizes;             // zmiany rozmiaru (rozpoczete migracje przy przyrostowej)
+    long long rehashNanoseconds;   // laczny czas przebudowy
+
+    TableStats() : size(0), capacity(0), tombstones(0), nodeBytes(0), countersEnabled(false), resizes(0), rehashNanoseconds(0) {}
+};
+
+#ifdef HASH_TABLE_STATS
+// Liczniki zmian rozmiaru przechowywane w tablicy
+struct ResizeCounters {
+    long long resizes;
+    long long rehashNanoseconds;
+
+    ResizeCounters() : resizes(0), rehashNanoseconds(0) {}
+
+    void fill(TableStats& stats) const {
+        stats.countersEnabled = true;
+        stats.resizes = resizes;
+        stats.rehashNanoseconds = rehashNanoseconds;
+    }
+};
+
+// Dodaje do licznikow czas od utworzenia do konca zakresu
+class RehashTimer {
+private:
+    ResizeCounters& counters;
+    chrono::steady_clock::time_point start;
+
+public:
+    explicit RehashTimer(ResizeCounters& counters) : counters(counters), start(chrono::steady_clock::now()) {}
+
+    ~RehashTimer() {
+        auto end = chrono::steady_clock::now();
+        counters.rehashNanoseconds += chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+    }
+
+    RehashTimer(const RehashTimer&) = delete;
+    RehashTimer& operator=(const RehashTimer&) = delete;
+};
+#endif
+
+#endif
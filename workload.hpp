@@ -0,0 +1,442 @@
+#ifndef WORKLOAD_HPP
+#define WORKLOAD_HPP
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <climits>
+#include <functional>
+#include <unordered_set>
+#include "hash_policy.hpp"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+#include <intrin.h>
+#endif
+
+using namespace std;
+
+// Generatory obciazen dla pomiarow: szybki generator liczb losowych
+// z ziarnem, strumienie kluczy o roznych rozkladach i mieszanki operacji
+// w stylu YCSB. Wszystko zalezy tylko od ziarna, wiec ten sam zestaw
+// danych mozna odtworzyc i podac kazdej tablicy.
+
+// Generator xoshiro256** - kilka razy szybszy od rand(), 64 bity wyniku
+// i okres 2^256 - 1. Stan jest inicjalizowany z ziarna przez splitmix64.
+class FastRandom {
+private:
+    unsigned long long state[4];
+
+    static unsigned long long rotl(unsigned long long x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    // Gorne 64 bity iloczynu a * b
+    static unsigned long long mulHigh(unsigned long long a, unsigned long long b) {
+#if defined(__SIZEOF_INT128__)
+        return (unsigned long long)(((unsigned __int128)a * b) >> 64);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+        return __umulh(a, b);
+#else
+        // Mnozenie na polowkach 32-bitowych
+        unsigned long long aLow = a & 0xffffffffull, aHigh = a >> 32;
+        unsigned long long bLow = b & 0xffffffffull, bHigh = b >> 32;
+        unsigned long long low = aLow * bLow;
+        unsigned long long middle1 = aHigh * bLow + (low >> 32);
+        unsigned long long middle2 = aLow * bHigh + (middle1 & 0xffffffffull);
+        return aHigh * bHigh + (middle1 >> 32) + (middle2 >> 32);
+#endif
+    }
+
+public:
+    explicit FastRandom(unsigned long long seed = 12345) {
+        setSeed(seed);
+    }
+
+    void setSeed(unsigned long long seed) {
+        for (int i = 0; i < 4; i++) {
+            seed += 0x9e3779b97f4a7c15ull;
+            unsigned long long z = seed;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            state[i] = z ^ (z >> 31);
+        }
+    }
+
+    unsigned long long next() {
+        unsigned long long result = rotl(state[1] * 5, 7) * 9;
+        unsigned long long t = state[1] << 17;
+
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+
+        return result;
+    }
+
+    // Liczba z [0, bound) - mnozenie zamiast dzielenia (metoda Lemire'a)
+    unsigned long long nextBelow(unsigned long long bound) {
+        return mulHigh(next(), bound);
+    }
+
+    // Liczba calkowita z [min, max]
+    int nextInt(int min, int max) {
+        return min + (int)nextBelow((unsigned long long)((long long)max - min + 1));
+    }
+
+    // Liczba rzeczywista z [0, 1)
+    double nextDouble() {
+        return (next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+};
+
+// Rozklad Zipfa na [0, n): element k wypada z prawdopodobienstwem
+// proporcjonalnym do 1 / (k + 1)^theta. Losowanie w czasie stalym metoda
+// Graya i in. (uzywana w YCSB); stala zeta(n) jest liczona raz, w O(n).
+class ZipfGenerator {
+private:
+    long long n;
+    double theta;
+    double alpha;
+    double zetaN;
+    double eta;
+    double half;     // 1 + 0.5^theta - prog drugiego elementu
+
+    static double zeta(long long count, double theta) {
+        double sum = 0;
+        for (long long i = 1; i <= count; i++) {
+            sum += 1.0 / pow((double)i, theta);
+        }
+        return sum;
+    }
+
+public:
+    // theta z (0, 1); YCSB uzywa 0.99
+    ZipfGenerator(long long n, double theta = 0.99) : n(n), theta(theta) {
+        alpha = 1.0 / (1.0 - theta);
+        zetaN = zeta(n, theta);
+        eta = (1.0 - pow(2.0 / n, 1.0 - theta)) / (1.0 - zeta(2, theta) / zetaN);
+        half = 1.0 + pow(0.5, theta);
+    }
+
+    // Ranga z [0, n); 0 - najczestszy element
+    long long next(FastRandom& random) {
+        double u = random.nextDouble();
+        double uz = u * zetaN;
+        if (uz < 1.0) {
+            return 0;
+        }
+        if (uz < half) {
+            return 1;
+        }
+        long long rank = (long long)(n * pow(eta * u - eta + 1.0, alpha));
+        return rank < n ? rank : n - 1;
+    }
+};
+
+// Rodzaje strumieni kluczy
+enum class KeyPattern {
+    UNIFORM,      // rownomiernie z [1, count * 10] (jak dotychczasowe testy)
+    SEQUENTIAL,   // kolejne liczby od losowego poczatku
+    STRIDED,      // wielokrotnosci pojemnosci tablicy - najgorszy przypadek dla key % capacity
+    CLUSTERED,    // grupy po CLUSTER_LENGTH kolejnych kluczy od losowych poczatkow
+    ZIPF,         // rozklad Zipfa na [1, count * 10], czeste klucze rozrzucone
+    FLOOD         // klucze trafiajace w maly fragment tablicy dla znanej polityki mieszania
+};
+
+const KeyPattern KEY_PATTERNS[] = { KeyPattern::UNIFORM, KeyPattern::SEQUENTIAL, KeyPattern::STRIDED,
+    KeyPattern::CLUSTERED, KeyPattern::ZIPF, KeyPattern::FLOOD };
+const int NUM_KEY_PATTERNS = sizeof(KEY_PATTERNS) / sizeof(KEY_PATTERNS[0]);
+
+// Dlugosc grupy kolejnych kluczy we wzorcu CLUSTERED
+const int CLUSTER_LENGTH = 64;
+
+// Czesc tablicy (1 / FLOOD_CONCENTRATION), w ktora trafiaja klucze FLOOD
+const int FLOOD_CONCENTRATION = 64;
+
+inline const char* keyPatternName(KeyPattern pattern) {
+    switch (pattern) {
+    case KeyPattern::UNIFORM: return "uniform";
+    case KeyPattern::SEQUENTIAL: return "sequential";
+    case KeyPattern::STRIDED: return "strided";
+    case KeyPattern::CLUSTERED: return "clustered";
+    case KeyPattern::ZIPF: return "zipf";
+    case KeyPattern::FLOOD: return "flood";
+    }
+    return "";
+}
+
+// Wzorzec o podanej nazwie; false gdy nazwa jest nieznana
+inline bool parseKeyPattern(const string& name, KeyPattern& pattern) {
+    for (int i = 0; i < NUM_KEY_PATTERNS; i++) {
+        if (name == keyPatternName(KEY_PATTERNS[i])) {
+            pattern = KEY_PATTERNS[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+// Pojemnosc (potega dwojki), jaka osiagnie tablica z count elementami
+// przy wspolczynniku wypelnienia 0.7 - najwieksza z tablic w repozytorium
+inline int expectedCapacity(int count) {
+    int capacity = 16;
+    while (count > capacity * 0.7) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+// Mieszanie rangi Zipfa, aby czeste klucze nie lezaly obok siebie
+inline unsigned long long scramble(unsigned long long x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    return x;
+}
+
+// Klucze trafiajace przy pojemnosci capacity do pierwszych
+// capacity / concentration indeksow polityki HashPolicy. Polityki biora
+// gorne (Fibonacci) albo dolne (modulo, Murmur) bity, wiec klucze skupiaja
+// sie tez przy mniejszych pojemnosciach. Losowanie z odrzucaniem -
+// srednio concentration prob na klucz.
+template <typename HashPolicy, typename Hash = hash<int>>
+vector<int> floodKeys(int count, int capacity, int concentration, FastRandom& random) {
+    HashPolicy policy;
+    policy.setCapacity(capacity);
+    Hash hasher;
+    int limit = max(1, capacity / concentration);
+
+    vector<int> keys;
+    keys.reserve(count);
+    while ((int)keys.size() < count) {
+        int key = random.nextInt(1, INT_MAX);
+        if (policy(hasher(key)) < limit) {
+            keys.push_back(key);
+        }
+    }
+    return keys;
+}
+
+// Strumien count kluczy wedlug wzorca. Klucze FLOOD sa dobierane pod
+// polityke FloodPolicy (domyslna polityka tablic szablonowych).
+template <typename FloodPolicy = FibonacciHash>
+vector<int> generateKeys(KeyPattern pattern, int count, FastRandom& random, double zipfTheta = 0.99) {
+    vector<int> keys(count);
+    int range = count * 10;
+
+    switch (pattern) {
+    case KeyPattern::UNIFORM:
+        for (int i = 0; i < count; i++) {
+            keys[i] = random.nextInt(1, range);
+        }
+        break;
+
+    case KeyPattern::SEQUENTIAL: {
+        int first = random.nextInt(1, range);
+        for (int i = 0; i < count; i++) {
+            keys[i] = first + i;
+        }
+        break;
+    }
+
+    case KeyPattern::STRIDED: {
+        // Krok rowny pojemnosci, zmniejszany az wszystkie klucze mieszcza sie w int
+        long long stride = expectedCapacity(count);
+        while (stride > 1 && stride * count > INT_MAX) {
+            stride /= 2;
+        }
+        for (int i = 0; i < count; i++) {
+            keys[i] = (int)(stride * (i + 1));
+        }
+        break;
+    }
+
+    case KeyPattern::CLUSTERED:
+        for (int i = 0; i < count; i += CLUSTER_LENGTH) {
+            int first = random.nextInt(1, range);
+            for (int j = i; j < min(i + CLUSTER_LENGTH, count); j++) {
+                keys[j] = first + (j - i);
+            }
+        }
+        break;
+
+    case KeyPattern::ZIPF: {
+        ZipfGenerator zipf(range, zipfTheta);
+        for (int i = 0; i < count; i++) {
+            keys[i] = 1 + (int)(scramble(zipf.next(random)) % (unsigned long long)range);
+        }
+        break;
+    }
+
+    case KeyPattern::FLOOD:
+        keys = floodKeys<FloodPolicy>(count, expectedCapacity(count), FLOOD_CONCENTRATION, random);
+        break;
+    }
+
+    return keys;
+}
+
+// count roznych kluczy rownomiernie z [first, last] (last - first + 1 >= count)
+inline vector<int> uniqueKeys(int count, int first, int last, FastRandom& random) {
+    unordered_set<int> used;
+    used.reserve(count);
+    vector<int> keys;
+    keys.reserve(count);
+    while ((int)keys.size() < count) {
+        int key = random.nextInt(first, last);
+        if (used.insert(key).second) {
+            keys.push_back(key);
+        }
+    }
+    return keys;
+}
+
+// Zestaw danych: klucze i wartosci z jednego ziarna
+struct Dataset {
+    vector<int> keys;
+    vector<int> values;
+};
+
+template <typename FloodPolicy = FibonacciHash>
+Dataset generateDataset(KeyPattern pattern, int count, unsigned long long seed, double zipfTheta = 0.99) {
+    FastRandom random(seed);
+    Dataset dataset;
+    dataset.keys = generateKeys<FloodPolicy>(pattern, count, random, zipfTheta);
+    dataset.values.resize(count);
+    for (int i = 0; i < count; i++) {
+        dataset.values[i] = random.nextInt(1, 1000);
+    }
+    return dataset;
+}
+
+// Rodzaje operacji w mieszance
+enum class OperationType {
+    READ,
+    UPDATE,   // zmiana wartosci istniejacego klucza
+    INSERT,   // nowy klucz spoza zaladowanych
+    REMOVE
+};
+
+struct Operation {
+    OperationType type;
+    int key;
+    int value;
+};
+
+// Udzialy (%) operacji w mieszance i rozklad wybieranych kluczy
+struct OperationMix {
+    const char* name;
+    int read;
+    int update;
+    int insert;
+    int remove;
+    bool zipf;      // istniejace klucze wybierane wedlug Zipfa (inaczej rownomiernie)
+    bool latest;    // odczyty preferuja ostatnio wstawione klucze (YCSB D)
+};
+
+// Mieszanki YCSB (A-D) i mieszanka z usuwaniem, ktorej YCSB nie ma
+const OperationMix OPERATION_MIXES[] = {
+    { "a", 50, 50, 0, 0, true, false },     // intensywne zmiany
+    { "b", 95, 5, 0, 0, true, false },      // glownie odczyty
+    { "c", 100, 0, 0, 0, true, false },     // tylko odczyty
+    { "d", 95, 0, 5, 0, false, true },      // odczyty najnowszych
+    { "churn", 50, 0, 25, 25, false, false } // wymiana kluczy: wstawienia i usuniecia
+};
+const int NUM_OPERATION_MIXES = sizeof(OPERATION_MIXES) / sizeof(OPERATION_MIXES[0]);
+
+// Mieszanka o podanej nazwie albo nullptr
+inline const OperationMix* findOperationMix(const string& name) {
+    for (int i = 0; i < NUM_OPERATION_MIXES; i++) {
+        if (name == OPERATION_MIXES[i].name) {
+            return &OPERATION_MIXES[i];
+        }
+    }
+    return nullptr;
+}
+
+// Strumien count operacji na tablicy zaladowanej kluczami loadedKeys
+// (kluczami dodatnimi - ujemne sa zostawione na klucze nieobecne).
+// Nowe klucze INSERT sa kolejnymi liczbami wiekszymi od wszystkich
+// zaladowanych, wiec naprawde dodaja elementy; gdy zabraknie ich przed
+// INT_MAX, sa losowane z [1, INT_MAX] sposrod jeszcze nieuzytych.
+// READ, UPDATE i REMOVE wybieraja klucze obecne w tablicy - usuniety klucz
+// wypada z puli, wiec mieszanka churn naprawde wymienia klucze. Gdy pula
+// jest pusta, zamiast nich powstaje INSERT.
+inline vector<Operation> generateOperations(const OperationMix& mix, const vector<int>& loadedKeys,
+    int count, FastRandom& random, double zipfTheta = 0.99) {
+    // Pula obecnych kluczy bez powtorzen (w kolejnosci wstawiania)
+    // i zbior wszystkich kiedykolwiek uzytych
+    vector<int> keys;
+    keys.reserve(loadedKeys.size() + count);
+    unordered_set<int> used;
+    used.reserve(loadedKeys.size() + count);
+    long long nextKey = 1;
+    for (size_t i = 0; i < loadedKeys.size(); i++) {
+        if (used.insert(loadedKeys[i]).second) {
+            keys.push_back(loadedKeys[i]);
+        }
+        nextKey = max(nextKey, (long long)loadedKeys[i] + 1);
+    }
+
+    ZipfGenerator zipf(max<long long>(2, (long long)keys.size() + (long long)count), zipfTheta);
+    vector<Operation> operations(count);
+
+    for (int i = 0; i < count; i++) {
+        int kind = random.nextInt(0, 99);
+        Operation& op = operations[i];
+        op.value = random.nextInt(1, 1000);
+
+        if (kind < mix.read + mix.update) {
+            op.type = kind < mix.read ? OperationType::READ : OperationType::UPDATE;
+        }
+        else if (kind < mix.read + mix.update + mix.insert) {
+            op.type = OperationType::INSERT;
+        }
+        else {
+            op.type = OperationType::REMOVE;
+        }
+
+        if (op.type == OperationType::INSERT || keys.empty()) {
+            op.type = OperationType::INSERT;
+            if (nextKey <= INT_MAX) {
+                op.key = (int)nextKey++;
+            }
+            else {
+                do {
+                    op.key = random.nextInt(1, INT_MAX);
+                } while (used.count(op.key) != 0);
+            }
+            used.insert(op.key);
+            keys.push_back(op.key);
+            continue;
+        }
+
+        // Wybor istniejacego klucza
+        long long index;
+        if (mix.latest) {
+            // Ranga Zipfa liczona od najnowszego klucza
+            index = (long long)keys.size() - 1 - zipf.next(random) % (long long)keys.size();
+        }
+        else if (mix.zipf) {
+            index = (long long)(scramble(zipf.next(random)) % keys.size());
+        }
+        else {
+            index = (long long)random.nextBelow(keys.size());
+        }
+        op.key = keys[index];
+
+        if (op.type == OperationType::REMOVE) {
+            // Usuniecie z puli przez zamiane z ostatnim
+            keys[index] = keys.back();
+            keys.pop_back();
+        }
+    }
+
+    return operations;
+}
+
+#endif